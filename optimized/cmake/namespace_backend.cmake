@@ -0,0 +1,41 @@
+# links the archive of a backend in a single relocatable object, and prefixes
+# every symbol it defines, so that the builds of the scheme for several
+# backends are linked in the same binary (see include/dispatch.h). The
+# symbols the archive does not define (libc, pthreads) are left untouched
+#
+# cmake -DLINKER=ld -DNM=nm -DOBJCOPY=objcopy -DPREFIX=speck_avx2_ \
+#       -DARCHIVE=libbackend.a -DOUTPUT=backend.o -P namespace_backend.cmake
+
+foreach(var LINKER NM OBJCOPY PREFIX ARCHIVE OUTPUT)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "namespace_backend: ${var} is not set")
+    endif()
+endforeach()
+
+execute_process(COMMAND ${LINKER} -r -o ${OUTPUT} --whole-archive ${ARCHIVE}
+                RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "namespace_backend: cannot link ${ARCHIVE}")
+endif()
+
+execute_process(COMMAND ${NM} -g --defined-only ${OUTPUT}
+                OUTPUT_VARIABLE symbols
+                RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "namespace_backend: cannot list the symbols of ${OUTPUT}")
+endif()
+
+# nm prints "address type name" per symbol
+string(REGEX MATCHALL "[^\n]+" lines "${symbols}")
+set(redefinitions "")
+foreach(line ${lines})
+    string(REGEX REPLACE "^.* " "" symbol "${line}")
+    string(APPEND redefinitions "${symbol} ${PREFIX}${symbol}\n")
+endforeach()
+file(WRITE ${OUTPUT}.symbols "${redefinitions}")
+
+execute_process(COMMAND ${OBJCOPY} --redefine-syms=${OUTPUT}.symbols ${OUTPUT}
+                RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "namespace_backend: cannot rename the symbols of ${OUTPUT}")
+endif()
@@ -17,40 +17,45 @@
 #pragma once
 
 #include "parameters.h"
+#include "speck_types.h"
+#include "sha3.h"
 #include <stddef.h>
 
-typedef struct __attribute__((packed)) {
-#ifdef SPECK_RESAMPLE_G
-   unsigned char G_0_seed[SEED_LENGTH_BYTES];
-#endif
-#ifdef SPECK_COMPRESS_G
-   uint8_t G_0_rref [SPECK_RREF_MAT_PACKEDBYTES];
-#endif
-#ifdef SPECK_FULL_G
-   uint8_t G_0_rref [K][K_pad];
-#endif
-#ifdef SPECK_COMPRESS_GP
-   uint8_t SF_G [NUM_KEYPAIRS-1][SPECK_RREF_MAT_PACKEDBYTES];
-#else
-   uint8_t SF_G [NUM_KEYPAIRS-1][K][K_pad];
-#endif
-} speck_pubkey_t;
-
-typedef struct __attribute__((packed)) {
-   uint8_t permutations[NUM_KEYPAIRS-1][N];
-   unsigned char sk_seed[PRIVATE_KEY_SEED_LENGTH_BYTES];
-} speck_prikey_t;
-
-typedef struct __attribute__((packed)) speck_sig_t {
-    uint8_t digest[HASH_DIGEST_LENGTH];
-    uint8_t salt[HASH_DIGEST_LENGTH];
-    #ifdef SPECK_COMPRESS_C1S
-    uint8_t c1s[SPECK_C1S_PACKEDBYTES];
-    #else
-    uint8_t c1s[W][K_pad];
-    #endif
-    uint8_t seed_storage[SEED_TREE_MAX_PUBLISHED_BYTES];
-} speck_sign_t;
+/* state of a signature or verification of a message provided in chunks,
+ * i.e., the hash states of the round commitments after absorbing them */
+typedef struct {
+   par_shake_ctx cmt_prefix;
+} speck_sign_ctx_t;
+
+typedef struct {
+   par_shake_ctx cmt_prefix;
+} speck_verify_ctx_t;
+
+/* scratch memory of the signature and verification, allocated by the
+ * caller: SPECK_workspace_bytes() bytes, aligned to SPECK_WORKSPACE_ALIGN.
+ * The verification variants and SPECK_sign_lowmem_ws need only
+ * SPECK_workspace_lowmem_bytes() bytes. It can be reused across calls, but
+ * not by concurrent ones */
+#define SPECK_WORKSPACE_ALIGN (64)
+typedef struct speck_workspace_s speck_workspace_t;
+
+size_t SPECK_workspace_bytes(void);
+
+size_t SPECK_workspace_lowmem_bytes(void);
+
+/* message independent part of a signature, precomputed offline and
+ * consumed by a single online signature. Allocated by the caller as the
+ * workspace: SPECK_bundle_bytes() bytes, aligned to SPECK_WORKSPACE_ALIGN */
+typedef struct speck_bundle_s speck_bundle_t;
+
+size_t SPECK_bundle_bytes(void);
+
+/* public key with its matrices unpacked once for the verification of
+ * several signatures. Allocated by the caller as the workspace:
+ * SPECK_prepared_pk_bytes() bytes, aligned to SPECK_WORKSPACE_ALIGN */
+typedef struct speck_prepared_pk_s speck_prepared_pk_t;
+
+size_t SPECK_prepared_pk_bytes(void);
 
 /* keygen cannot fail */
 void SPECK_keygen(speck_prikey_t *SK,
@@ -63,8 +68,154 @@ size_t SPECK_sign(const speck_prikey_t *SK,
                const uint64_t mlen,
                speck_sign_t *sig);
 
+/* same as SPECK_sign, computing the T rounds with num_threads threads; the
+ * signature is bit-identical to the single threaded one. The calling thread
+ * is helped by num_threads-1 threads of a pool, started on first use and
+ * kept for the later calls */
+size_t SPECK_sign_mt(const speck_prikey_t *SK,
+               const speck_pubkey_t *PK,
+               const char *const m,
+               const uint64_t mlen,
+               speck_sign_t *sig,
+               uint32_t num_threads);
+
+/* same as SPECK_sign_mt, with the bulk of the memory taken from ws */
+size_t SPECK_sign_mt_ws(const speck_prikey_t *SK,
+               const speck_pubkey_t *PK,
+               const char *const m,
+               const uint64_t mlen,
+               speck_sign_t *sig,
+               uint32_t num_threads,
+               speck_workspace_t *ws);
+
+/* same as SPECK_sign, with the bulk of the memory taken from ws */
+size_t SPECK_sign_ws(const speck_prikey_t *SK,
+               const speck_pubkey_t *PK,
+               const char *const m,
+               const uint64_t mlen,
+               speck_sign_t *sig,
+               speck_workspace_t *ws);
+
+/* same as SPECK_sign_ws, recomputing the W challenged codewords from their
+ * seeds instead of storing all the T ones; the seeds of the rounds are
+ * streamed from a depth-first walk of the seed tree, which is not stored.
+ * The signature is the same */
+size_t SPECK_sign_lowmem_ws(const speck_prikey_t *SK,
+               const speck_pubkey_t *PK,
+               const char *const m,
+               const uint64_t mlen,
+               speck_sign_t *sig,
+               speck_workspace_t *ws);
+
+/* signs msgs[i] into sigs[i] as SPECK_sign does. A convenience wrapper,
+ * not faster than signing the messages one at a time */
+void SPECK_sign_batch(const speck_prikey_t *SK,
+               const speck_pubkey_t *PK,
+               const char *const msgs[],
+               const uint64_t lens[],
+               speck_sign_t sigs[],
+               const uint32_t num_msgs);
+
+/* same as SPECK_sign_batch, with the bulk of the memory taken from ws */
+void SPECK_sign_batch_ws(const speck_prikey_t *SK,
+               const speck_pubkey_t *PK,
+               const char *const msgs[],
+               const uint64_t lens[],
+               speck_sign_t sigs[],
+               const uint32_t num_msgs,
+               speck_workspace_t *ws);
+
+/* fills bundle with a fresh salt, seed tree and the round codewords */
+void SPECK_bundle_precompute(const speck_prikey_t *SK,
+               const speck_pubkey_t *PK,
+               speck_bundle_t *bundle);
+
+/* same as SPECK_bundle_precompute, with the salt and the root seed of the
+ * tree provided by the caller instead of drawn with randombytes */
+void SPECK_bundle_precompute_seeded(const speck_prikey_t *SK,
+               const speck_pubkey_t *PK,
+               const unsigned char salt[HASH_DIGEST_LENGTH],
+               const unsigned char ephem_permutations_seed[SEED_LENGTH_BYTES],
+               speck_bundle_t *bundle);
+
+/* signs hashing the precomputed rounds of bundle, which is then erased;
+ * returns 0 without signing if the bundle was already used */
+size_t SPECK_sign_with_bundle(const speck_prikey_t *SK,
+               const char *const m,
+               const uint64_t mlen,
+               speck_sign_t *sig,
+               speck_bundle_t *bundle);
+
+/* streaming signature: the message is absorbed chunk by chunk, final
+ * computes the same signature as SPECK_sign on the concatenated chunks and
+ * leaves the context untouched */
+void SPECK_sign_init(speck_sign_ctx_t *ctx);
+
+void SPECK_sign_update(speck_sign_ctx_t *ctx,
+               const char *const m,
+               const uint64_t mlen);
+
+size_t SPECK_sign_final(const speck_prikey_t *SK,
+               const speck_pubkey_t *PK,
+               const speck_sign_ctx_t *ctx,
+               speck_sign_t *sig);
+
+size_t SPECK_sign_final_ws(const speck_prikey_t *SK,
+               const speck_pubkey_t *PK,
+               const speck_sign_ctx_t *ctx,
+               speck_sign_t *sig,
+               speck_workspace_t *ws);
+
 /* verify returns 1 if signature is ok, 0 otherwise */
 int SPECK_verify(const speck_pubkey_t *const PK,
                 const char *const m,
                 const uint64_t mlen,
                 const speck_sign_t *const sig);
+
+/* same as SPECK_verify, computing the T rounds with num_threads threads of
+ * the pool of SPECK_sign_mt */
+int SPECK_verify_mt(const speck_pubkey_t *const PK,
+                const char *const m,
+                const uint64_t mlen,
+                const speck_sign_t *const sig,
+                uint32_t num_threads);
+
+/* same as SPECK_verify_mt, with the bulk of the memory taken from ws */
+int SPECK_verify_mt_ws(const speck_pubkey_t *const PK,
+                const char *const m,
+                const uint64_t mlen,
+                const speck_sign_t *const sig,
+                uint32_t num_threads,
+                speck_workspace_t *ws);
+
+/* same as SPECK_verify, with the bulk of the memory taken from ws */
+int SPECK_verify_ws(const speck_pubkey_t *const PK,
+                const char *const m,
+                const uint64_t mlen,
+                const speck_sign_t *const sig,
+                speck_workspace_t *ws);
+
+void SPECK_prepare_pk(const speck_pubkey_t *const PK,
+                speck_prepared_pk_t *prepared);
+
+/* same as SPECK_verify, with the public key prepared by SPECK_prepare_pk */
+int SPECK_verify_prepared(const speck_prepared_pk_t *prepared,
+                const char *const m,
+                const uint64_t mlen,
+                const speck_sign_t *const sig);
+
+/* streaming verification, see SPECK_sign_init */
+void SPECK_verify_init(speck_verify_ctx_t *ctx);
+
+void SPECK_verify_update(speck_verify_ctx_t *ctx,
+                const char *const m,
+                const uint64_t mlen);
+
+int SPECK_verify_final(const speck_pubkey_t *const PK,
+                const speck_verify_ctx_t *ctx,
+                const speck_sign_t *const sig);
+
+int SPECK_verify_final_ws(const speck_pubkey_t *const PK,
+                const speck_verify_ctx_t *ctx,
+                const speck_sign_t *const sig,
+                speck_workspace_t *ws);
@@ -122,8 +122,19 @@ void antiorthogonal_sample(FQ_ELEM A[K][K_pad],
 void generator_sample(rref_generator_mat_t *res,
                               const unsigned char seed[SEED_LENGTH_BYTES]);
 
+/// adds to the histogram mset the len elements of a strip of a product,
+/// while it is still in the L1 cache
 static inline
-void row_mat_mult(FQ_ELEM *out,
+void strip_histogram(FQ_ELEM *mset, const FQ_ELEM *strip, uint32_t len){
+    for (uint32_t i = 0; i < len; i++) {
+        mset[strip[i]]++;
+    }
+}
+
+#ifdef USE_AVX2
+/// reduces the products of every matrix row before accumulating them
+static inline
+void row_mat_mult_eager(FQ_ELEM *out,
                     const FQ_ELEM *vec,
                     const FQ_ELEM M[K][K_pad],
                     uint8_t r,
@@ -187,8 +198,83 @@ void row_mat_mult(FQ_ELEM *out,
 
 }
 
+/// accumulates in res the product of the 32 widened coefficients of a
+/// matrix row (a_lo, a_hi) by the scalar b, as in row_mat_mult
+#define ROW_MAT_MULT_ACC(res, a_lo, a_hi, b)                 \
+  {                                                          \
+    vec256_t p_lo, p_hi, s;                                  \
+    vset17(s, b);                                            \
+    p_lo = a_lo;                                             \
+    p_hi = a_hi;                                             \
+    barrett_mul_u16(p_lo, p_lo, s, t);                       \
+    barrett_mul_u16(p_hi, p_hi, s, t);                       \
+    vshuffle8(p_lo, p_lo, shuffle);                          \
+    vshuffle8(p_hi, p_hi, shuffle);                          \
+    vpermute_4x64(p_lo, p_lo, 0xd8);                         \
+    vpermute_4x64(p_hi, p_hi, 0x87);                         \
+    t = _mm256_blend_epi32(p_lo, p_hi, 0xf0);                \
+    W_RED127_(t);                                            \
+    vadd8(res, res, t)                                       \
+    W_RED127_(res);                                          \
+  }
+
+/// same as row_mat_mult_eager on 4 vectors at once: each row of M is loaded
+/// and widened once for the 4 of them, instead of once per vector. If mset
+/// is not NULL, the c elements of each product are also counted in the
+/// corresponding histogram, one strip at a time
 static inline
-void row_mat_mult_opp_tran(FQ_ELEM *out,
+void row_mat_mult_x4_eager(FQ_ELEM *const out[4],
+                     FQ_ELEM *const *mset,
+                     const FQ_ELEM *const vec[4],
+                     const FQ_ELEM M[K][K_pad],
+                     uint8_t r,
+                     uint8_t c){
+
+    vec256_t shuffle, t, c7f, c01, a, a_lo, a_hi;
+    vec256_t res0, res1, res2, res3;
+    vec128_t tmp;
+    vset8(c7f, 127);
+    vset8(c01, 1);
+
+    vload256(shuffle, (vec256_t *) shuff_low_half);
+
+    for (uint32_t col = 0; (col+32) <= NEXT_MULTIPLE(c, 32); col+=32) {
+        vset8(res0, 0);
+        vset8(res1, 0);
+        vset8(res2, 0);
+        vset8(res3, 0);
+
+        for (uint32_t row = 0; row < r; row+=1){
+            vload256(a, (vec256_t *)(M[row]+col));
+
+            vget_lo(tmp, a);
+            vextend8_16(a_lo, tmp);
+            vget_hi(tmp, a);
+            vextend8_16(a_hi, tmp);
+
+            ROW_MAT_MULT_ACC(res0, a_lo, a_hi, vec[0][row]);
+            ROW_MAT_MULT_ACC(res1, a_lo, a_hi, vec[1][row]);
+            ROW_MAT_MULT_ACC(res2, a_lo, a_hi, vec[2][row]);
+            ROW_MAT_MULT_ACC(res3, a_lo, a_hi, vec[3][row]);
+        }
+
+        vstore256((vec256_t *)(out[0] + col), res0);
+        vstore256((vec256_t *)(out[1] + col), res1);
+        vstore256((vec256_t *)(out[2] + col), res2);
+        vstore256((vec256_t *)(out[3] + col), res3);
+
+        if (mset != NULL) {
+            const uint32_t len = (c - col < 32) ? c - col : 32;
+            for (uint32_t j = 0; j < 4; j++) {
+                strip_histogram(mset[j], out[j] + col, len);
+            }
+        }
+    }
+
+}
+
+static inline
+void row_mat_mult_opp_tran_eager(FQ_ELEM *out,
                     const FQ_ELEM *vec,
                     const FQ_ELEM M[K][K_pad],
                     uint8_t r,
@@ -253,6 +339,327 @@ void row_mat_mult_opp_tran(FQ_ELEM *out,
 
 }
 
+/* Lazy reduction: the products of a matrix row are only partially reduced
+ * by barrett_mul_u16 to at most 126 + 127 = 253, and summed in 16-bit lanes.
+ * Since r < 256 rows sum to at most 255*253 < 2^16, the sums are reduced
+ * once per 32-column strip instead of twice per row */
+
+/// accumulates in the 16-bit lanes acc_lo, acc_hi the partially reduced
+/// product of the 32 widened coefficients of a matrix row by the scalar b
+#define ROW_MAT_MULT_ACC_LAZY(acc_lo, acc_hi, a_lo, a_hi, b) \
+  {                                                          \
+    vec256_t p_lo, p_hi, s;                                  \
+    vset17(s, b);                                            \
+    p_lo = a_lo;                                             \
+    p_hi = a_hi;                                             \
+    barrett_mul_u16(p_lo, p_lo, s, t);                       \
+    barrett_mul_u16(p_hi, p_hi, s, t);                       \
+    acc_lo = _mm256_add_epi16(acc_lo, p_lo);                 \
+    acc_hi = _mm256_add_epi16(acc_hi, p_hi);                 \
+  }
+
+/// reduces the 16-bit sums x < 2^16 to [0, Q): two folds x = (x & 127) +
+/// (x >> 7) bring x below 132, then 127 is subtracted if needed
+#define W_RED127_16(x)                                                         \
+  x = _mm256_add_epi16(_mm256_and_si256(x, c7f16), _mm256_srli_epi16(x, 7));   \
+  x = _mm256_add_epi16(_mm256_and_si256(x, c7f16), _mm256_srli_epi16(x, 7));   \
+  x = _mm256_and_si256(                                                        \
+      _mm256_add_epi16(x, _mm256_srli_epi16(_mm256_add_epi16(x, c0116), 7)),   \
+      c7f16);
+
+/// reduces the sums acc_lo, acc_hi of a strip and packs them in res
+#define ROW_MAT_MULT_REDUCE_LAZY(res, acc_lo, acc_hi)        \
+  {                                                          \
+    W_RED127_16(acc_lo);                                     \
+    W_RED127_16(acc_hi);                                     \
+    res = _mm256_packus_epi16(acc_lo, acc_hi);               \
+    vpermute_4x64(res, res, 0xd8);                           \
+  }
+
+/// same as row_mat_mult_eager, reducing once per strip
+static inline
+void row_mat_mult_lazy(FQ_ELEM *out,
+                       const FQ_ELEM *vec,
+                       const FQ_ELEM M[K][K_pad],
+                       uint8_t r,
+                       uint8_t c){
+
+    vec256_t t, c7f16, c0116, a, a_lo, a_hi, acc_lo, acc_hi, res;
+    vec128_t tmp;
+    vset17(c7f16, 127);
+    vset17(c0116, 1);
+
+    for (uint32_t col = 0; (col+32) <= NEXT_MULTIPLE(c, 32); col+=32) {
+        vset17(acc_lo, 0);
+        vset17(acc_hi, 0);
+
+        for (uint32_t row = 0; row < r; row+=1){
+            vload256(a, (vec256_t *)(M[row]+col));
+
+            vget_lo(tmp, a);
+            vextend8_16(a_lo, tmp);
+            vget_hi(tmp, a);
+            vextend8_16(a_hi, tmp);
+
+            ROW_MAT_MULT_ACC_LAZY(acc_lo, acc_hi, a_lo, a_hi, vec[row]);
+        }
+
+        ROW_MAT_MULT_REDUCE_LAZY(res, acc_lo, acc_hi);
+        vstore256((vec256_t *)(out + col), res);
+    }
+
+}
+
+/// same as row_mat_mult_x4_eager, reducing once per strip
+static inline
+void row_mat_mult_x4_lazy(FQ_ELEM *const out[4],
+                          FQ_ELEM *const *mset,
+                          const FQ_ELEM *const vec[4],
+                          const FQ_ELEM M[K][K_pad],
+                          uint8_t r,
+                          uint8_t c){
+
+    vec256_t t, c7f16, c0116, a, a_lo, a_hi, res;
+    vec256_t acc0_lo, acc0_hi, acc1_lo, acc1_hi, acc2_lo, acc2_hi, acc3_lo, acc3_hi;
+    vec128_t tmp;
+    vset17(c7f16, 127);
+    vset17(c0116, 1);
+
+    for (uint32_t col = 0; (col+32) <= NEXT_MULTIPLE(c, 32); col+=32) {
+        vset17(acc0_lo, 0);
+        vset17(acc0_hi, 0);
+        vset17(acc1_lo, 0);
+        vset17(acc1_hi, 0);
+        vset17(acc2_lo, 0);
+        vset17(acc2_hi, 0);
+        vset17(acc3_lo, 0);
+        vset17(acc3_hi, 0);
+
+        for (uint32_t row = 0; row < r; row+=1){
+            vload256(a, (vec256_t *)(M[row]+col));
+
+            vget_lo(tmp, a);
+            vextend8_16(a_lo, tmp);
+            vget_hi(tmp, a);
+            vextend8_16(a_hi, tmp);
+
+            ROW_MAT_MULT_ACC_LAZY(acc0_lo, acc0_hi, a_lo, a_hi, vec[0][row]);
+            ROW_MAT_MULT_ACC_LAZY(acc1_lo, acc1_hi, a_lo, a_hi, vec[1][row]);
+            ROW_MAT_MULT_ACC_LAZY(acc2_lo, acc2_hi, a_lo, a_hi, vec[2][row]);
+            ROW_MAT_MULT_ACC_LAZY(acc3_lo, acc3_hi, a_lo, a_hi, vec[3][row]);
+        }
+
+        ROW_MAT_MULT_REDUCE_LAZY(res, acc0_lo, acc0_hi);
+        vstore256((vec256_t *)(out[0] + col), res);
+        ROW_MAT_MULT_REDUCE_LAZY(res, acc1_lo, acc1_hi);
+        vstore256((vec256_t *)(out[1] + col), res);
+        ROW_MAT_MULT_REDUCE_LAZY(res, acc2_lo, acc2_hi);
+        vstore256((vec256_t *)(out[2] + col), res);
+        ROW_MAT_MULT_REDUCE_LAZY(res, acc3_lo, acc3_hi);
+        vstore256((vec256_t *)(out[3] + col), res);
+
+        if (mset != NULL) {
+            const uint32_t len = (c - col < 32) ? c - col : 32;
+            for (uint32_t j = 0; j < 4; j++) {
+                strip_histogram(mset[j], out[j] + col, len);
+            }
+        }
+    }
+
+}
+
+/// same as row_mat_mult_opp_tran_eager, reducing once per strip
+static inline
+void row_mat_mult_opp_tran_lazy(FQ_ELEM *out,
+                                const FQ_ELEM *vec,
+                                const FQ_ELEM M[K][K_pad],
+                                uint8_t r,
+                                uint8_t c,
+                                uint8_t row_off){
+
+    vec256_t t, c7f16, c0116, a, a_lo, a_hi, acc_lo, acc_hi, res;
+    vec128_t tmp;
+    vset17(c7f16, 127);
+    vset17(c0116, 1);
+
+    for (uint32_t col = 0; (col+32) <= NEXT_MULTIPLE(c, 32); col+=32) {
+        vset17(acc_lo, 0);
+        vset17(acc_hi, 0);
+
+        for (uint32_t row = 0; row < r; row+=1){
+            vload256(a, (vec256_t *)(M[row+row_off]+col));
+
+            vget_lo(tmp, a);
+            vextend8_16(a_lo, tmp);
+            vget_hi(tmp, a);
+            vextend8_16(a_hi, tmp);
+
+            ROW_MAT_MULT_ACC_LAZY(acc_lo, acc_hi, a_lo, a_hi, fq_opp(vec[row]));
+        }
+
+        ROW_MAT_MULT_REDUCE_LAZY(res, acc_lo, acc_hi);
+        vstore256((vec256_t *)(out + col), res);
+    }
+
+}
+#else
+/* portable kernels: every product is reduced, on the same 32-column strips
+ * as the vector ones, so the padding columns of out are written alike */
+
+/// accumulates in acc the product of a strip of the row M_row by b
+static inline
+void row_mat_mult_strip_acc(FQ_ELEM acc[32], const FQ_ELEM *M_row, FQ_ELEM b){
+    for (uint32_t i = 0; i < 32; i++) {
+        acc[i] = fq_add(acc[i], fq_mul(b, M_row[i]));
+    }
+}
+
+static inline
+void row_mat_mult_eager(FQ_ELEM *out,
+                        const FQ_ELEM *vec,
+                        const FQ_ELEM M[K][K_pad],
+                        uint8_t r,
+                        uint8_t c){
+    for (uint32_t col = 0; (col+32) <= NEXT_MULTIPLE(c, 32); col+=32) {
+        FQ_ELEM acc[32] = {0};
+        for (uint32_t row = 0; row < r; row+=1){
+            row_mat_mult_strip_acc(acc, M[row]+col, vec[row]);
+        }
+        memcpy(out + col, acc, 32);
+    }
+}
+
+static inline
+void row_mat_mult_x4_eager(FQ_ELEM *const out[4],
+                           FQ_ELEM *const *mset,
+                           const FQ_ELEM *const vec[4],
+                           const FQ_ELEM M[K][K_pad],
+                           uint8_t r,
+                           uint8_t c){
+    for (uint32_t col = 0; (col+32) <= NEXT_MULTIPLE(c, 32); col+=32) {
+        FQ_ELEM acc[4][32] = {{0}};
+        for (uint32_t row = 0; row < r; row+=1){
+            for (uint32_t j = 0; j < 4; j++) {
+                row_mat_mult_strip_acc(acc[j], M[row]+col, vec[j][row]);
+            }
+        }
+        for (uint32_t j = 0; j < 4; j++) {
+            memcpy(out[j] + col, acc[j], 32);
+        }
+
+        if (mset != NULL) {
+            const uint32_t len = (c - col < 32) ? c - col : 32;
+            for (uint32_t j = 0; j < 4; j++) {
+                strip_histogram(mset[j], out[j] + col, len);
+            }
+        }
+    }
+}
+
+static inline
+void row_mat_mult_opp_tran_eager(FQ_ELEM *out,
+                                 const FQ_ELEM *vec,
+                                 const FQ_ELEM M[K][K_pad],
+                                 uint8_t r,
+                                 uint8_t c,
+                                 uint8_t row_off){
+    for (uint32_t col = 0; (col+32) <= NEXT_MULTIPLE(c, 32); col+=32) {
+        FQ_ELEM acc[32] = {0};
+        for (uint32_t row = 0; row < r; row+=1){
+            row_mat_mult_strip_acc(acc, M[row+row_off]+col, fq_opp(vec[row]));
+        }
+        memcpy(out + col, acc, 32);
+    }
+}
+
+/* there is no lazy reduction without the 16-bit lanes */
+static inline
+void row_mat_mult_lazy(FQ_ELEM *out,
+                       const FQ_ELEM *vec,
+                       const FQ_ELEM M[K][K_pad],
+                       uint8_t r,
+                       uint8_t c){
+    row_mat_mult_eager(out, vec, M, r, c);
+}
+
+static inline
+void row_mat_mult_x4_lazy(FQ_ELEM *const out[4],
+                          FQ_ELEM *const *mset,
+                          const FQ_ELEM *const vec[4],
+                          const FQ_ELEM M[K][K_pad],
+                          uint8_t r,
+                          uint8_t c){
+    row_mat_mult_x4_eager(out, mset, vec, M, r, c);
+}
+
+static inline
+void row_mat_mult_opp_tran_lazy(FQ_ELEM *out,
+                                const FQ_ELEM *vec,
+                                const FQ_ELEM M[K][K_pad],
+                                uint8_t r,
+                                uint8_t c,
+                                uint8_t row_off){
+    row_mat_mult_opp_tran_eager(out, vec, M, r, c, row_off);
+}
+#endif
+
+/* the kernels employed by the scheme, see SPECK_LAZY_REDUCTION */
+static inline
+void row_mat_mult(FQ_ELEM *out,
+                  const FQ_ELEM *vec,
+                  const FQ_ELEM M[K][K_pad],
+                  uint8_t r,
+                  uint8_t c){
+#ifdef SPECK_LAZY_REDUCTION
+    row_mat_mult_lazy(out, vec, M, r, c);
+#else
+    row_mat_mult_eager(out, vec, M, r, c);
+#endif
+}
+
+static inline
+void row_mat_mult_x4(FQ_ELEM *const out[4],
+                     const FQ_ELEM *const vec[4],
+                     const FQ_ELEM M[K][K_pad],
+                     uint8_t r,
+                     uint8_t c){
+#ifdef SPECK_LAZY_REDUCTION
+    row_mat_mult_x4_lazy(out, NULL, vec, M, r, c);
+#else
+    row_mat_mult_x4_eager(out, NULL, vec, M, r, c);
+#endif
+}
+
+/// same as row_mat_mult_x4, adding the c elements of each product to the
+/// corresponding histogram in mset
+static inline
+void row_mat_mult_x4_histogram(FQ_ELEM *const out[4],
+                               FQ_ELEM *const mset[4],
+                               const FQ_ELEM *const vec[4],
+                               const FQ_ELEM M[K][K_pad],
+                               uint8_t r,
+                               uint8_t c){
+#ifdef SPECK_LAZY_REDUCTION
+    row_mat_mult_x4_lazy(out, mset, vec, M, r, c);
+#else
+    row_mat_mult_x4_eager(out, mset, vec, M, r, c);
+#endif
+}
+
+static inline
+void row_mat_mult_opp_tran(FQ_ELEM *out,
+                           const FQ_ELEM *vec,
+                           const FQ_ELEM M[K][K_pad],
+                           uint8_t r,
+                           uint8_t c,
+                           uint8_t row_off){
+#ifdef SPECK_LAZY_REDUCTION
+    row_mat_mult_opp_tran_lazy(out, vec, M, r, c, row_off);
+#else
+    row_mat_mult_opp_tran_eager(out, vec, M, r, c, row_off);
+#endif
+}
+
 void row_mat_mult_avx2(FQ_ELEM *out,
                     const FQ_ELEM *row,
                     FQ_ELEM M[K][K_pad],
@@ -124,18 +124,16 @@ void csprng_initialize_x4(CSPRNG_X4_STATE_T * const csprng_state,
                           const uint16_t dsc3,
                           const uint16_t dsc4) {
    xof_shake_x4_init(csprng_state);
-   xof_shake_x4_update(csprng_state,seed1,seed2,seed3,seed4,seed_len_bytes);
-   uint8_t dsc_ordered1[2], dsc_ordered2[2], dsc_ordered3[2], dsc_ordered4[2];
-   dsc_ordered1[0] = dsc1 & 0xff;
-   dsc_ordered1[1] = (dsc1 >> 8) & 0xff;
-   dsc_ordered2[0] = dsc2 & 0xff;
-   dsc_ordered2[1] = (dsc2 >> 8) & 0xff;
-   dsc_ordered3[0] = dsc3 & 0xff;
-   dsc_ordered3[1] = (dsc3 >> 8) & 0xff;
-   dsc_ordered4[0] = dsc4 & 0xff;
-   dsc_ordered4[1] = (dsc4 >> 8) & 0xff;
-   xof_shake_x4_update(csprng_state,dsc_ordered1,dsc_ordered2,dsc_ordered3,dsc_ordered4,2);
-   xof_shake_x4_final(csprng_state);
+   const uint8_t dsc_ordered[4][2] = {
+      {dsc1 & 0xff, (dsc1 >> 8) & 0xff},
+      {dsc2 & 0xff, (dsc2 >> 8) & 0xff},
+      {dsc3 & 0xff, (dsc3 >> 8) & 0xff},
+      {dsc4 & 0xff, (dsc4 >> 8) & 0xff}
+   };
+   const unsigned char *const seeds[4] = {seed1, seed2, seed3, seed4};
+   const unsigned char *const dscs[4] = {dsc_ordered[0], dsc_ordered[1], dsc_ordered[2], dsc_ordered[3]};
+   /* the domain separator is laid out in the last block with the seeds */
+   xof_shake_x4_update_final(csprng_state,seeds,seed_len_bytes,dscs,2);
 }
 /* randombytes */
 static inline
@@ -235,6 +233,67 @@ void hash_par(int par_level,
    par_xof_output(par_level, &states, digest_1, digest_2, digest_3, digest_4, HASH_DIGEST_LENGTH);
 }
 
+/* hash_par on inputs sharing a common prefix: the prefix is absorbed once
+ * into the state of the given parallelism level, which is then cloned by
+ * hash_par_from_prefix, so that only the suffixes are absorbed per call.
+ * The digests are the same as the ones of hash_par on prefix||suffix */
+static inline
+void hash_par_prefix_init(int par_level, PAR_CSPRNG_STATE_T * const prefix) {
+   if(par_level == 1) xof_shake_init(&(prefix->state1), SEED_LENGTH_BYTES*8);
+   else if(par_level == 2) xof_shake_x2_init(&(prefix->state2), SEED_LENGTH_BYTES*8);
+   else if(par_level == 3 || par_level == 4) xof_shake_x4_init(&(prefix->state4));
+}
+static inline
+void hash_par_prefix_update(int par_level,
+                            PAR_CSPRNG_STATE_T * const prefix,
+                            const unsigned char *const in,
+                            const uint64_t inlen) {
+   if(par_level == 1) xof_shake_update(&(prefix->state1), in, inlen);
+   else if(par_level == 2) xof_shake_x2_update(&(prefix->state2), in, in, inlen);
+   else if(par_level == 3 || par_level == 4) xof_shake_x4_update(&(prefix->state4), in, in, in, in, inlen);
+}
+static inline
+void hash_par_from_prefix(int par_level,
+                          const PAR_CSPRNG_STATE_T * const prefix,
+                          uint8_t digest_1[HASH_DIGEST_LENGTH],
+                          uint8_t digest_2[HASH_DIGEST_LENGTH],
+                          uint8_t digest_3[HASH_DIGEST_LENGTH],
+                          uint8_t digest_4[HASH_DIGEST_LENGTH],
+                          const unsigned char *const m_1,
+                          const unsigned char *const m_2,
+                          const unsigned char *const m_3,
+                          const unsigned char *const m_4,
+                          const uint64_t mlen,
+                          const uint16_t dsc1,
+                          const uint16_t dsc2,
+                          const uint16_t dsc3,
+                          const uint16_t dsc4) {
+   PAR_CSPRNG_STATE_T states;
+   uint8_t dsc_ordered[4][2] = {
+      {dsc1 & 0xff, (dsc1 >> 8) & 0xff},
+      {dsc2 & 0xff, (dsc2 >> 8) & 0xff},
+      {dsc3 & 0xff, (dsc3 >> 8) & 0xff},
+      {dsc4 & 0xff, (dsc4 >> 8) & 0xff}
+   };
+   if(par_level == 1) {
+      states.state1 = prefix->state1;
+      xof_shake_update(&(states.state1), m_1, mlen);
+      xof_shake_update(&(states.state1), dsc_ordered[0], 2);
+      xof_shake_final(&(states.state1));
+   } else if(par_level == 2) {
+      states.state2 = prefix->state2;
+      xof_shake_x2_update(&(states.state2), m_1, m_2, mlen);
+      xof_shake_x2_update(&(states.state2), dsc_ordered[0], dsc_ordered[1], 2);
+      xof_shake_x2_final(&(states.state2));
+   } else if(par_level == 3 || par_level == 4) {
+      states.state4 = prefix->state4;
+      const unsigned char *const ms[4] = {m_1, m_2, m_3, m_4};
+      const unsigned char *const dscs[4] = {dsc_ordered[0], dsc_ordered[1], dsc_ordered[2], dsc_ordered[3]};
+      xof_shake_x4_update_final(&(states.state4), ms, mlen, dscs, 2);
+   }
+   par_xof_output(par_level, &states, digest_1, digest_2, digest_3, digest_4, HASH_DIGEST_LENGTH);
+}
+
 /***************** Specialized CSPRNGs for non binary domains *****************/
 
 /* CSPRNG sampling fixed weight strings */
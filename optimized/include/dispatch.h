@@ -0,0 +1,140 @@
+/**
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ''AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "speck_types.h"
+#include "sha3.h"
+
+/* runtime dispatch between the builds of the scheme: the whole scheme is
+ * compiled once per backend, and each build is linked with its symbols
+ * prefixed (see cmake/namespace_backend.cmake). The kernels are inlined in
+ * their callers, so the table is at the level of the API: the entry points
+ * below forward to the backend resolved once from CPUID. The environment
+ * variable SPECK_BACKEND (portable or avx2) overrides the choice, an
+ * unsupported backend falling back to portable.
+ * Only the entry points declared here are forwarded: the rest of SPECK.h
+ * (streaming contexts, workspaces, bundles, prepared keys) is laid out by
+ * each backend, and is not available through the dispatch */
+typedef enum {
+   SPECK_BACKEND_PORTABLE = 0,
+   SPECK_BACKEND_AVX2 = 1,
+   SPECK_NUM_BACKENDS
+} speck_backend_t;
+
+typedef struct {
+   const char *name;
+   /* the global CSPRNG of the backend, each backend keeps the SHAKE state
+    * in the layout of its own Keccak-f permutation */
+   SHAKE_STATE_STRUCT *csprng_state;
+   void (*initialize_csprng)(SHAKE_STATE_STRUCT *shake_state,
+                             const unsigned char *seed,
+                             const uint32_t seed_len_bytes);
+   void (*keygen)(speck_prikey_t *SK,
+                  speck_pubkey_t *PK);
+   size_t (*sign)(const speck_prikey_t *SK,
+                  const speck_pubkey_t *PK,
+                  const char *const m,
+                  const uint64_t mlen,
+                  speck_sign_t *sig);
+   size_t (*sign_mt)(const speck_prikey_t *SK,
+                     const speck_pubkey_t *PK,
+                     const char *const m,
+                     const uint64_t mlen,
+                     speck_sign_t *sig,
+                     uint32_t num_threads);
+   int (*verify)(const speck_pubkey_t *const PK,
+                 const char *const m,
+                 const uint64_t mlen,
+                 const speck_sign_t *const sig);
+   int (*verify_mt)(const speck_pubkey_t *const PK,
+                    const char *const m,
+                    const uint64_t mlen,
+                    const speck_sign_t *const sig,
+                    uint32_t num_threads);
+   int (*crypto_sign_keypair)(unsigned char *pk,
+                              unsigned char *sk);
+   int (*crypto_sign)(unsigned char *sm,
+                      unsigned long long *smlen,
+                      const unsigned char *m,
+                      unsigned long long mlen,
+                      const unsigned char *sk,
+                      const unsigned char *pk);
+   int (*crypto_sign_open)(unsigned char *m,
+                           unsigned long long *mlen,
+                           const unsigned char *sm,
+                           unsigned long long smlen,
+                           const unsigned char *pk);
+} speck_backend_api_t;
+
+/* backend employed by the entry points, resolved on the first call */
+speck_backend_t SPECK_backend(void);
+
+const char *SPECK_backend_name(speck_backend_t backend);
+
+/* returns NULL if the host does not support the backend */
+const speck_backend_api_t *SPECK_backend_api(speck_backend_t backend);
+
+/* seeds the global CSPRNG of the selected backend, see init_randombytes */
+void SPECK_init_randombytes(const unsigned char *seed,
+                            const uint32_t seed_len_bytes);
+
+/* entry points of SPECK.h and api.h, forwarded to the selected backend */
+void SPECK_keygen(speck_prikey_t *SK,
+                 speck_pubkey_t *PK);
+
+size_t SPECK_sign(const speck_prikey_t *SK,
+               const speck_pubkey_t *PK,
+               const char *const m,
+               const uint64_t mlen,
+               speck_sign_t *sig);
+
+size_t SPECK_sign_mt(const speck_prikey_t *SK,
+               const speck_pubkey_t *PK,
+               const char *const m,
+               const uint64_t mlen,
+               speck_sign_t *sig,
+               uint32_t num_threads);
+
+int SPECK_verify(const speck_pubkey_t *const PK,
+                const char *const m,
+                const uint64_t mlen,
+                const speck_sign_t *const sig);
+
+int SPECK_verify_mt(const speck_pubkey_t *const PK,
+                const char *const m,
+                const uint64_t mlen,
+                const speck_sign_t *const sig,
+                uint32_t num_threads);
+
+int crypto_sign_keypair(unsigned char *pk,
+                        unsigned char *sk);
+
+int crypto_sign(unsigned char *sm,
+                unsigned long long *smlen,
+                const unsigned char *m,
+                unsigned long long mlen,
+                const unsigned char *sk,
+                const unsigned char *pk);
+
+int crypto_sign_open(unsigned char *m,
+                     unsigned long long *mlen,
+                     const unsigned char *sm,
+                     unsigned long long smlen,
+                     const unsigned char *pk);
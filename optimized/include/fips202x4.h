@@ -41,7 +41,11 @@
  * 
  */
 
+#ifdef USE_AVX2
 #include "KeccakP-1600-times4-SnP.h"
+#else
+#include "KeccakP-1600-times4-portable-SnP.h"
+#endif
 
 /************************************************
  *  Macros
@@ -69,13 +73,17 @@
  ***********************************************/
 
 typedef struct {
-    KeccakP1600times4_SIMD256_states state;
+    KeccakP1600times4_states state;
     /* - during absrbtion: "offset" is the number of absorbed bytes that have already been xored into the state but have not been permuted yet
      * - during squeezing: "offset" is the number of not-yet-squeezed bytes */
     uint64_t offset;
+    /* bytes absorbed or squeezed per permutation, RATE unless chosen with
+     * keccak_x4_init_rate */
+    unsigned int rate;
 } par_keccak_context;
 
 void keccak_x4_init(par_keccak_context *ctx);
+void keccak_x4_init_rate(par_keccak_context *ctx, unsigned int rate);
 void keccak_x4_absorb(
     par_keccak_context *ctx, 
     const unsigned char *in1, 
@@ -84,6 +92,13 @@ void keccak_x4_absorb(
     const unsigned char *in4, 
     unsigned int in_len);
 void keccak_x4_finalize(par_keccak_context *ctx);
+/* same as absorbing in, then tail, then finalizing */
+void keccak_x4_absorb_final(
+    par_keccak_context *ctx,
+    const unsigned char *const in[4],
+    unsigned int in_len,
+    const unsigned char *const tail[4],
+    unsigned int tail_len);
 void keccak_x4_squeeze(
     par_keccak_context *ctx, 
     unsigned char *out1, 
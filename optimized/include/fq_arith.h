@@ -43,6 +43,59 @@ static inline void FUNC_NAME(SHAKE_STATE_STRUCT *shake_monomial_state, EL_T *buf
       } \
    } while (1); }
 
+#ifdef USE_AVX2
+/* rejection samples the nine 7-bit fields of word, in order, writing the
+ * accepted ones plus min_value at out: the eight low fields are spread one per
+ * byte with pdep, the ones above span are found with a carry into the top bit
+ * of their byte, and the others are left-packed with pext. out must have room
+ * for 9 elements; returns the number of accepted ones */
+static inline
+uint32_t rnd_pack7_word(uint8_t *out,
+                        const uint64_t word,
+                        const uint8_t span,
+                        const uint8_t min_value) {
+   const uint64_t ONES = 0x0101010101010101ULL;
+   const uint64_t fields = _pdep_u64(word, 0x7f7f7f7f7f7f7f7fULL);
+   const uint64_t accepted = (((fields + (0x7f - span) * ONES) >> 7) & ONES) ^ ONES;
+   const uint64_t packed = _pext_u64(fields + min_value * ONES, accepted * 0xff);
+   memcpy(out, &packed, sizeof(uint64_t));
+   uint32_t count = __builtin_popcountll(accepted);
+   const uint8_t last = (word >> 56) & 0x7f;
+   out[count] = last + min_value;
+   return count + (last <= span);
+}
+#endif
+
+/* same as DEF_RAND_STATE, reading the words from a buffered CSPRNG reader.
+ * With AVX2, the 7-bit samplers take whole words through rnd_pack7_word while
+ * a word cannot overshoot num_elements */
+#ifdef USE_AVX2
+#define RAND_READER_PACK7(reader, buffer, count, num_elements, SPAN, MIN_VALUE, REQ_BITS, EL_T) \
+   if (REQ_BITS == 7 && sizeof(EL_T) == 1) { \
+      while (count + 9 <= num_elements) { \
+         count += rnd_pack7_word((uint8_t *) buffer + count, \
+                                 csprng_reader_next_word(reader), SPAN, MIN_VALUE); \
+      } \
+   }
+#else
+#define RAND_READER_PACK7(reader, buffer, count, num_elements, SPAN, MIN_VALUE, REQ_BITS, EL_T)
+#endif
+
+#define DEF_RAND_READER(FUNC_NAME, EL_T, MINV, MAXV) \
+static inline void FUNC_NAME(csprng_reader_t *reader, EL_T *buffer, size_t num_elements) { \
+   static const EL_T MIN_VALUE = (MINV);\
+   static const EL_T MAX_VALUE = (MAXV); \
+   static const EL_T SPAN = MAX_VALUE - MIN_VALUE; \
+   static const size_t REQ_BITS = BITS_TO_REPRESENT(SPAN); \
+   size_t count = 0; \
+   csprng_reader_drop_bits(reader); \
+   RAND_READER_PACK7(reader, buffer, count, num_elements, SPAN, MIN_VALUE, REQ_BITS, EL_T) \
+   while (count < num_elements) { \
+      EL_T rnd_value = (EL_T) csprng_reader_next_bits(reader, REQ_BITS); \
+      if (rnd_value <= SPAN) buffer[count++] = rnd_value + MIN_VALUE; \
+   } \
+   csprng_reader_drop_bits(reader); }
+
 #define DEF_RAND(FUNC_NAME, EL_T, MINV, MAXV) \
 static inline void FUNC_NAME(EL_T *buffer, size_t num_elements) { \
    typedef uint64_t WORD_T; \
@@ -172,6 +225,11 @@ DEF_RAND_STATE(fq_star_rnd_state_elements, FQ_ELEM, 1, Q-1)
 
 DEF_RAND_STATE(rand_range_q_state_elements, FQ_ELEM, 0, Q-1)
 
+/* Sampling functions from a buffered reader on a PRNG state */
+DEF_RAND_READER(fq_star_rnd_reader_elements, FQ_ELEM, 1, Q-1)
+
+DEF_RAND_READER(rand_range_q_reader_elements, FQ_ELEM, 0, Q-1)
+
 /// NOTE: these functions are outsourced to this file, to make the
 /// optimizied implementation as easy as possible.
 /// accumulates a row
@@ -192,6 +250,7 @@ FQ_ELEM row_acc_old(const FQ_ELEM *d) {
 /// accumulates a row
 /// \param d
 /// \return sum(d) for _ in range(N-K)
+#ifdef USE_AVX2
 static inline
 FQ_ELEM row_acc(const FQ_ELEM *d) {
     vec256_t s, t, c01, c7f;
@@ -210,6 +269,16 @@ FQ_ELEM row_acc(const FQ_ELEM *d) {
     uint32_t k = vhadd8(s);
     return fq_red(k);
 }
+#else
+static inline
+FQ_ELEM row_acc(const FQ_ELEM *d) {
+    FQ_ELEM s = 0;
+    for (uint32_t col = 0; col < N_K_pad; col++) {
+        s = fq_add(s, d[col]);
+    }
+    return s;
+}
+#endif
 
 
 /// accumulates the inverse of a row
@@ -239,6 +308,7 @@ void row_mul_old(FQ_ELEM *row, const FQ_ELEM s) {
 /// NOTE: not a full reduction
 /// \param row[in/out] *= s for _ in range(N-K)
 /// \param s
+#ifdef USE_AVX2
 static inline
 void row_mul(FQ_ELEM *row, const FQ_ELEM s) {
     vec256_t shuffle, t, c7f, c01, a, a_lo, a_hi, b;
@@ -276,6 +346,14 @@ void row_mul(FQ_ELEM *row, const FQ_ELEM s) {
         vstore256((vec256_t *)(row + col), t);
     }
 }
+#else
+static inline
+void row_mul(FQ_ELEM *row, const FQ_ELEM s) {
+    for (uint32_t col = 0; col < N_K_pad; col++) {
+        row[col] = fq_mul(s, row[col]);
+    }
+}
+#endif
 
 /// scalar multiplication of a row
 /// \param out = s*in[i] for i in range(N-K)
@@ -301,6 +379,7 @@ void row_mul3(FQ_ELEM *out, const FQ_ELEM *in1, const FQ_ELEM *in2) {
 /// \param out = in1[i]*in2[i] for i in range(N-K)
 /// \param in1
 /// \param in2
+#ifdef USE_AVX2
 static inline
 void row_mul3_avx2(FQ_ELEM *out, const FQ_ELEM *in1, const FQ_ELEM *in2) {
     vec256_t shuffle, t, c7f, c01, a, a_lo, a_hi, b, b_lo, b_hi, res;
@@ -343,6 +422,7 @@ void row_mul3_avx2(FQ_ELEM *out, const FQ_ELEM *in1, const FQ_ELEM *in2) {
         vstore256((vec256_t *)(out + col), t);
     }
 }
+#endif
 
 /// sum of rows
 /// \param out[i] = out[i] + s*in[i] for i in range(N-K)
@@ -355,6 +435,7 @@ void row_sum_old(FQ_ELEM *out, const FQ_ELEM *in, const FQ_ELEM s, uint8_t c) {
     }
 }
 
+#ifdef USE_AVX2
 static inline
 void row_sum(FQ_ELEM *out, const FQ_ELEM *in, const FQ_ELEM s, uint8_t c) {
 
@@ -404,6 +485,15 @@ void row_sum(FQ_ELEM *out, const FQ_ELEM *in, const FQ_ELEM s, uint8_t c) {
         vstore256((vec256_t *)(out + col), in1);
     }
 }
+#else
+/// same as the vector version, on whole strips of 32 elements
+static inline
+void row_sum(FQ_ELEM *out, const FQ_ELEM *in, const FQ_ELEM s, uint8_t c) {
+    for (uint32_t col = 0; col < NEXT_MULTIPLE(c,32); col++) {
+        out[col] = fq_add(out[col], fq_mul(in[col], s));
+    }
+}
+#endif
 
 /// Inner product of a row
 /// \param out = sum(in[i]*in[i] for i in range(K))
@@ -421,6 +511,7 @@ void inner_prod_old(FQ_ELEM *out, const FQ_ELEM *in) {
 /// \param out = sum(in[i]*in[i] for i in range(K))
 /// \param in
 /// \param s
+#ifdef USE_AVX2
 static inline
 void inner_prod(FQ_ELEM *out, const FQ_ELEM *in) {
 
@@ -464,6 +555,15 @@ void inner_prod(FQ_ELEM *out, const FQ_ELEM *in) {
     uint32_t k = vhadd8(s);
     *out = fq_red(k);
 }
+#else
+static inline
+void inner_prod(FQ_ELEM *out, const FQ_ELEM *in) {
+    *out = 0;
+    for (uint32_t col = 0; col < N_K_pad; col++) {
+        *out = fq_add(*out, fq_mul(in[col], in[col]));
+    }
+}
+#endif
 
 static inline
 uint8_t anti_normalize(FQ_ELEM c[K_pad]){
@@ -26,20 +26,22 @@
 #include <stdint.h>
 #include <string.h>
 #include <stdio.h>
-#include <immintrin.h>
 
 #include "fq_arith.h"
 
-typedef __m256i vec256_t;
-typedef __m128i vec128_t;
-
-
 /// number of Fq elements per vector register
 #define LESS_WSZ 32u
 
 // number of vector register for N bytes
 #define NW ((NEXT_MULTIPLE(N, LESS_WSZ))/LESS_WSZ)
 
+/* the portable builds employ the scalar kernels, see fq_arith.h and codes.h */
+#ifdef USE_AVX2
+#include <immintrin.h>
+
+typedef __m256i vec256_t;
+typedef __m128i vec128_t;
+
 
 // c <- src
 #define vload256(c, src) c = _mm256_loadu_si256(src);
@@ -205,3 +207,4 @@ static inline uint8_t vhadd8(const __m256i in) {
 
     return _mm256_extract_epi8(t, 0);
 }
+#endif
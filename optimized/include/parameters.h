@@ -113,18 +113,12 @@
 /// rounds x to the next multiple of n
 #define NEXT_MULTIPLE(x,n) ((((x)+((n)-1u))/(n))*(n))
 
-#if defined(USE_AVX2) || defined(USE_NEON)
 /// In case of the optimized implementation, we need that all vectors
-/// are of a length, which is a multiple of 32
+/// are of a length, which is a multiple of 32; the portable kernels work on
+/// the same 32 element strips, so that both builds share the layouts
 #define N_K_pad NEXT_MULTIPLE(N-K, 32)
 #define N_pad   NEXT_MULTIPLE(N, 32)
 #define K_pad   NEXT_MULTIPLE(K, 32)
-#else
-/// in case of the reference implementation, we do not need this behaviour.
-#define N_K_pad (N-K)
-#define N_pad   N
-#define K_pad   K
-#endif
 
 #define Q_pad   NEXT_MULTIPLE(Q, 8)
 
@@ -184,6 +178,8 @@
 
 #define SPECK_COMPRESS_C1S
 
+#define SPECK_LAZY_REDUCTION // <- Reduce the matrix-vector products once per column strip
+
 #ifdef SPECK_COMPRESS_C1S
 #define SPECK_SIGNATURE_SIZE(NR_LEAVES) (HASH_DIGEST_LENGTH*2 + SPECK_C1S_PACKEDBYTES + NR_LEAVES*SEED_LENGTH_BYTES + 1)
 #else
@@ -28,6 +28,8 @@ void yt_shuffle_state_limit(SHAKE_STATE_STRUCT *shake_monomial_state,
                             const uint32_t n);
 void yt_shuffle_state(SHAKE_STATE_STRUCT *shake_monomial_state,
                       POSITION_T permutation[N]);
+void yt_shuffle_reader(csprng_reader_t *reader,
+                       POSITION_T permutation[N]);
 void yt_shuffle(POSITION_T permutation[N]);
 
 void permutation_sample_prikey(permutation_t *res,
@@ -47,3 +49,9 @@ void word_sample_salt(
                           const unsigned char seed[SEED_LENGTH_BYTES],
                           const unsigned char salt[HASH_DIGEST_LENGTH],
                           const uint16_t round_index);
+
+void word_sample_salt_x4(
+                          FQ_ELEM *const u[4],
+                          const unsigned char *const seed[4],
+                          const unsigned char salt[HASH_DIGEST_LENGTH],
+                          const uint16_t round_index[4]);
@@ -0,0 +1,58 @@
+/**
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ''AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **/
+
+#pragma once
+
+#include "SPECK.h"
+#include <stdint.h>
+
+/* pool of bundles (see SPECK_bundle_precompute) for a single keypair, kept
+ * full by a low priority background thread. Each bundle is handed out to
+ * exactly one SPECK_presign_pool_sign; when none is ready, the signature is
+ * computed inline. The pool draws its randomness from the global CSPRNG
+ * under an internal lock: no other thread must employ randombytes while the
+ * pool is alive */
+typedef struct speck_presign_pool_s speck_presign_pool_t;
+
+typedef struct {
+   uint32_t capacity;
+   /* bundles ready to be handed out */
+   uint32_t depth;
+   /* signatures employing a bundle, and computed inline */
+   uint64_t hits;
+   uint64_t misses;
+   /* bundles computed by the background thread, and their latency */
+   uint64_t refills;
+   uint64_t refill_ns_total;
+   uint64_t refill_ns_max;
+} speck_presign_pool_stats_t;
+
+/* returns NULL if the memory or the background thread are not available */
+speck_presign_pool_t *SPECK_presign_pool_create(const speck_prikey_t *SK,
+               const speck_pubkey_t *PK,
+               uint32_t capacity);
+
+/* stops the background thread and erases the bundles left */
+void SPECK_presign_pool_destroy(speck_presign_pool_t *pool);
+
+/* same as SPECK_sign with the keypair of the pool; thread safe */
+size_t SPECK_presign_pool_sign(speck_presign_pool_t *pool,
+               const char *const m,
+               const uint64_t mlen,
+               speck_sign_t *sig);
+
+void SPECK_presign_pool_stats(speck_presign_pool_t *pool,
+               speck_presign_pool_stats_t *stats);
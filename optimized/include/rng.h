@@ -17,7 +17,9 @@
 
 #include "parameters.h"
 #include "sha3.h"
+#include "align.h"
 #include <stddef.h>
+#include <string.h>
 
 /* initializes a CSPRNG, given the seed and a state pointer */
 void initialize_csprng(SHAKE_STATE_STRUCT *shake_state,
@@ -41,6 +43,182 @@ void csprng_randombytes(unsigned char *x,
    xof_shake_extract(shake_state, x, xlen);
 }
 
+/* buffered reader on a CSPRNG: squeezes whole SHAKE128 blocks, and hands out
+ * bytes, 64-bit words or bit fields from them. The byte stream is the one of
+ * csprng_randombytes on the same state; csprng_reader_next_bits takes its
+ * fields from a single word, dropping the bits left, as the rejection
+ * samplers do */
+typedef struct {
+   SHAKE_STATE_STRUCT state;
+   /* unread bits of the current word */
+   uint64_t word;
+   uint32_t word_bits;
+   /* first unread byte of block */
+   uint32_t pos;
+   ALIGN(32) uint8_t block[SHAKE128_RATE];
+} csprng_reader_t;
+
+static inline
+void csprng_reader_init(csprng_reader_t *reader,
+                        const unsigned char *seed,
+                        const uint32_t seed_len_bytes)
+{
+   initialize_csprng(&reader->state, seed, seed_len_bytes);
+   reader->word = 0;
+   reader->word_bits = 0;
+   reader->pos = SHAKE128_RATE;
+}
+
+/* extracts xlen bytes from the reader, dropping the bits left of the current
+ * word */
+static inline
+void csprng_reader_fill(csprng_reader_t *reader,
+                        unsigned char *x,
+                        size_t xlen)
+{
+   reader->word_bits = 0;
+   while (xlen > 0) {
+      if (reader->pos == SHAKE128_RATE) {
+         xof_shake_extract(&reader->state, reader->block, SHAKE128_RATE);
+         reader->pos = 0;
+      }
+      size_t chunk = SHAKE128_RATE - reader->pos;
+      chunk = chunk < xlen ? chunk : xlen;
+      memcpy(x, reader->block + reader->pos, chunk);
+      reader->pos += chunk;
+      x += chunk;
+      xlen -= chunk;
+   }
+}
+
+/* next 64-bit word of the stream, dropping the bits left of the current one */
+static inline
+uint64_t csprng_reader_next_word(csprng_reader_t *reader)
+{
+   uint64_t word;
+   if (reader->pos + sizeof(uint64_t) <= SHAKE128_RATE) {
+      memcpy(&word, reader->block + reader->pos, sizeof(uint64_t));
+      reader->pos += sizeof(uint64_t);
+      reader->word_bits = 0;
+   } else {
+      csprng_reader_fill(reader, (unsigned char *) &word, sizeof(uint64_t));
+   }
+   return word;
+}
+
+/* next num_bits <= 64 bits of the current word, moving to the next word when
+ * the current one has less than num_bits bits left */
+static inline
+uint64_t csprng_reader_next_bits(csprng_reader_t *reader,
+                                 const uint32_t num_bits)
+{
+   if (reader->word_bits < num_bits) {
+      reader->word = csprng_reader_next_word(reader);
+      reader->word_bits = 64;
+   }
+   const uint64_t value = num_bits == 64 ? reader->word :
+                          reader->word & (((uint64_t) 1 << num_bits) - 1);
+   reader->word = num_bits == 64 ? 0 : reader->word >> num_bits;
+   reader->word_bits -= num_bits;
+   return value;
+}
+
+/* drops the bits left of the current word: the next bit field starts a word */
+static inline
+void csprng_reader_drop_bits(csprng_reader_t *reader)
+{
+   reader->word_bits = 0;
+}
+
+/* four buffered readers on the four SHAKE128 instances of the x4 Keccak. The
+ * blocks of the instances are squeezed together by csprng_x4_reader_refill,
+ * which drops whatever is left of the previous ones: a lane is read until it
+ * is exhausted or no longer needed */
+typedef struct {
+   SHAKE_X4_STATE_STRUCT state;
+   uint64_t word[4];
+   uint32_t word_bits[4];
+   uint32_t pos[4];
+   ALIGN(32) uint8_t block[4][SHAKE128_RATE];
+} csprng_x4_reader_t;
+
+static inline
+void csprng_x4_reader_init(csprng_x4_reader_t *reader,
+                           const unsigned char *seed1,
+                           const unsigned char *seed2,
+                           const unsigned char *seed3,
+                           const unsigned char *seed4,
+                           const uint32_t seed_len_bytes)
+{
+   xof_shake128_x4_init(&reader->state);
+   xof_shake_x4_update(&reader->state, seed1, seed2, seed3, seed4, seed_len_bytes);
+   xof_shake_x4_final(&reader->state);
+   for (uint32_t j = 0; j < 4; j++) {
+      reader->word[j] = 0;
+      reader->word_bits[j] = 0;
+      reader->pos[j] = SHAKE128_RATE;
+   }
+}
+
+static inline
+void csprng_x4_reader_refill(csprng_x4_reader_t *reader)
+{
+   xof_shake_x4_extract(&reader->state, reader->block[0], reader->block[1],
+                        reader->block[2], reader->block[3], SHAKE128_RATE);
+   for (uint32_t j = 0; j < 4; j++) {
+      reader->word_bits[j] = 0;
+      reader->pos[j] = 0;
+   }
+}
+
+/* whether the block of the lane still holds a whole word */
+static inline
+int csprng_x4_reader_has_word(const csprng_x4_reader_t *reader,
+                              const uint32_t lane)
+{
+   return reader->pos[lane] + sizeof(uint64_t) <= SHAKE128_RATE;
+}
+
+/* same as csprng_reader_next_word on a lane; the lane must have the word */
+static inline
+uint64_t csprng_x4_reader_next_word(csprng_x4_reader_t *reader,
+                                    const uint32_t lane)
+{
+   uint64_t word;
+   memcpy(&word, reader->block[lane] + reader->pos[lane], sizeof(uint64_t));
+   reader->pos[lane] += sizeof(uint64_t);
+   reader->word_bits[lane] = 0;
+   return word;
+}
+
+/* whether the block of the lane still holds num_bits bits for
+ * csprng_x4_reader_next_bits */
+static inline
+int csprng_x4_reader_has_bits(const csprng_x4_reader_t *reader,
+                              const uint32_t lane,
+                              const uint32_t num_bits)
+{
+   return reader->word_bits[lane] >= num_bits ||
+          csprng_x4_reader_has_word(reader, lane);
+}
+
+/* same as csprng_reader_next_bits on a lane; the lane must have the bits */
+static inline
+uint64_t csprng_x4_reader_next_bits(csprng_x4_reader_t *reader,
+                                    const uint32_t lane,
+                                    const uint32_t num_bits)
+{
+   if (reader->word_bits[lane] < num_bits) {
+      reader->word[lane] = csprng_x4_reader_next_word(reader, lane);
+      reader->word_bits[lane] = 64;
+   }
+   const uint64_t value = num_bits == 64 ? reader->word[lane] :
+                          reader->word[lane] & (((uint64_t) 1 << num_bits) - 1);
+   reader->word[lane] = num_bits == 64 ? 0 : reader->word[lane] >> num_bits;
+   reader->word_bits[lane] -= num_bits;
+   return value;
+}
+
 /* global csprng state employed to have a deterministic randombytes for testing */
 extern SHAKE_STATE_STRUCT platform_csprng_state;
 
@@ -24,6 +24,11 @@ void BuildGGM(unsigned char seed_tree[NUM_NODES_SEED_TREE * SEED_LENGTH_BYTES],
               const unsigned char root_seed[SEED_LENGTH_BYTES],
               const unsigned char salt[HASH_DIGEST_LENGTH]) ;
 
+/* same as BuildGGM, expanding one node at a time */
+void BuildGGM_scalar(unsigned char seed_tree[NUM_NODES_SEED_TREE * SEED_LENGTH_BYTES],
+              const unsigned char root_seed[SEED_LENGTH_BYTES],
+              const unsigned char salt[HASH_DIGEST_LENGTH]) ;
+
 /******************************************************************************/
 
 /* returns the number of seeds which have been published */
@@ -42,3 +47,50 @@ uint32_t RebuildGGM(unsigned char seed_tree[NUM_NODES_SEED_TREE*SEED_LENGTH_BYTE
 
 void seed_leaves(unsigned char rounds_seeds[T*SEED_LENGTH_BYTES],
                  unsigned char seed_tree[NUM_NODES_SEED_TREE*SEED_LENGTH_BYTES]);
+
+/* returns the seed of round i in seed_tree, i.e., the i-th one copied by
+ * seed_leaves */
+const unsigned char *seed_leaf(const unsigned char seed_tree[NUM_NODES_SEED_TREE*SEED_LENGTH_BYTES],
+                               uint32_t i);
+
+/******************************************************************************/
+
+typedef struct {
+    unsigned char seed[SEED_LENGTH_BYTES];
+    uint16_t node;
+    uint8_t level;
+} ggm_node_t;
+
+/* each step of the walk replaces at most four nodes of the same depth with
+ * their children, one level deeper */
+#define GGM_WALK_STACK_SIZE (4*LOG2(T)+4)
+
+/* depth-first walk of the seed tree from its root, keeping only the pending
+ * nodes of a left to right cut of the tree */
+typedef struct {
+    ggm_node_t stack[GGM_WALK_STACK_SIZE];
+    uint32_t num_nodes;
+    const uint64_t *flags;
+    uint16_t first_leaf[LOG2(T)+1];
+    unsigned char salt[HASH_DIGEST_LENGTH];
+} ggm_walk_t;
+
+/* starts a walk yielding the leaves of the tree built by BuildGGM, in the
+ * order of seed_leaves, without storing the tree */
+void GGMLeavesInit(ggm_walk_t *walk,
+                   const unsigned char root_seed[SEED_LENGTH_BYTES],
+                   const unsigned char salt[HASH_DIGEST_LENGTH]);
+
+/* returns the number of leaves yielded, 4 but at the end of the walk */
+uint32_t GGMLeavesNext(ggm_walk_t *walk,
+                       unsigned char leaves[4][SEED_LENGTH_BYTES]);
+
+/* same as GGMPath on the tree built by BuildGGM, expanding from the root
+ * only the ancestors of the leaves not to be published; their seeds are
+ * stored in order into unpublished_leaves.
+ * returns the number of seeds which have been published */
+uint32_t GGMPathFromRoot(const unsigned char root_seed[SEED_LENGTH_BYTES],
+                         const unsigned char salt[HASH_DIGEST_LENGTH],
+                         const unsigned char indices_to_publish[T],
+                         unsigned char *seed_storage,
+                         unsigned char *unpublished_leaves);
@@ -78,6 +78,10 @@ void xof_shake_extract(SHAKE_STATE_STRUCT *state,
 static inline void xof_shake_x4_init(SHAKE_X4_STATE_STRUCT *states) {
    keccak_x4_init(states);
 }
+/* four SHAKE128 instances, matching the x1 ones */
+static inline void xof_shake128_x4_init(SHAKE_X4_STATE_STRUCT *states) {
+   keccak_x4_init_rate(states, SHAKE128_RATE);
+}
 static inline void xof_shake_x4_update(SHAKE_X4_STATE_STRUCT *states,
                       const unsigned char *in1,
                       const unsigned char *in2,
@@ -89,6 +93,14 @@ static inline void xof_shake_x4_update(SHAKE_X4_STATE_STRUCT *states,
 static inline void xof_shake_x4_final(SHAKE_X4_STATE_STRUCT *states) {
    keccak_x4_finalize(states);
 }
+/* update with in, then with the (short) tail, and final in a single pass */
+static inline void xof_shake_x4_update_final(SHAKE_X4_STATE_STRUCT *states,
+                      const unsigned char *const in[4],
+                      uint32_t singleInputByteLen,
+                      const unsigned char *const tail[4],
+                      uint32_t singleTailByteLen) {
+   keccak_x4_absorb_final(states, in, singleInputByteLen, tail, singleTailByteLen);
+}
 static inline void xof_shake_x4_extract(SHAKE_X4_STATE_STRUCT *states,
                        unsigned char *out1,
                        unsigned char *out2,
@@ -59,4 +59,14 @@ void histogram_c1_c2(FQ_ELEM *mset,
                 const FQ_ELEM *c2,
                 const uint32_t size);
 
+/* one-table versions of histogram and histogram_c1_c2 */
+void histogram_scalar(FQ_ELEM *mset,
+                const FQ_ELEM *to_order,
+                const uint32_t size);
+
+void histogram_c1_c2_scalar(FQ_ELEM *mset,
+                const FQ_ELEM *c1,
+                const FQ_ELEM *c2,
+                const uint32_t size);
+
 #endif //SORT_H
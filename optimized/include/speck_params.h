@@ -0,0 +1,76 @@
+/**
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ''AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* all the parameter sets in a single library: the scheme is compiled once
+ * per TARGET and backend, so that every instance keeps the loop bounds and
+ * the tree tables of parameters.h as constants, and each build is linked
+ * with its symbols prefixed by speck_t<TARGET>_<backend>_ (see
+ * cmake/namespace_backend.cmake). As with the runtime dispatch of
+ * include/dispatch.h, the handles returned are the ones of the AVX2 builds
+ * if the CPU supports them, of the portable builds otherwise, and the
+ * environment variable SPECK_BACKEND (portable or avx2) overrides the
+ * choice. The structures of SPECK.h change size with the parameter set,
+ * hence the handles expose the byte oriented API of api.h. This header does
+ * not depend on TARGET, it is the only one a user of the library includes */
+typedef struct {
+   const char *name;
+   /* "portable" or "avx2" */
+   const char *backend;
+   uint32_t n;
+   uint32_t k;
+   /* number of rounds, and of the rounds with a non-zero challenge */
+   uint32_t t;
+   uint32_t w;
+   size_t public_key_bytes;
+   size_t secret_key_bytes;
+   /* worst case, the signed messages are at most mlen + signature_bytes */
+   size_t signature_bytes;
+   /* seeds the global CSPRNG of the instance, see init_randombytes */
+   void (*init_randombytes)(const unsigned char *seed,
+                            const uint32_t seed_len_bytes);
+   int (*crypto_sign_keypair)(unsigned char *pk,
+                              unsigned char *sk);
+   int (*crypto_sign)(unsigned char *sm,
+                      unsigned long long *smlen,
+                      const unsigned char *m,
+                      unsigned long long mlen,
+                      const unsigned char *sk,
+                      const unsigned char *pk);
+   int (*crypto_sign_open)(unsigned char *m,
+                           unsigned long long *mlen,
+                           const unsigned char *sm,
+                           unsigned long long smlen,
+                           const unsigned char *pk);
+} speck_params_t;
+
+/* number of parameter sets in the library */
+uint32_t SPECK_num_params(void);
+
+/* the i-th parameter set, by increasing t, NULL if i is out of range */
+const speck_params_t *SPECK_params_at(uint32_t i);
+
+/* the parameter set with t rounds, NULL if the library does not have it */
+const speck_params_t *SPECK_params(uint32_t t);
+
+/* same as SPECK_params, for the named backend instead of the selected one;
+ * NULL if the host does not support it */
+const speck_params_t *SPECK_params_backend(uint32_t t,
+                                           const char *backend);
@@ -33,3 +33,8 @@ void SampleChallenge(uint8_t fixed_weight_string[T],
 int verify(const uint8_t *a,
            const uint8_t *b,
            const size_t len);
+
+/* zeroes len bytes from p, also when they are not read afterwards, e.g.,
+ * right before being freed */
+void wipe(void *p,
+          const size_t len);
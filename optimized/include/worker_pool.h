@@ -0,0 +1,39 @@
+/**
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ''AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **/
+
+#pragma once
+
+#include <stdint.h>
+
+/* persistent threads running the chunks of rounds of the threaded
+ * signature and verification. The threads are started on demand, up to the
+ * largest number of concurrent tasks requested so far, and are then kept
+ * waiting for further tasks, so that a call does not pay for the creation
+ * of its threads. The pool is shared by all the callers */
+typedef struct worker_task_s {
+   void (*run)(void *arg);
+   void *arg;
+   /* internal: queue of the pending tasks, and completion flag */
+   struct worker_task_s *next;
+   int done;
+} worker_task_t;
+
+/* runs tasks[0] on the calling thread and the other ones on the pool, and
+ * returns once all of them are completed. While waiting, the calling thread
+ * runs the pending tasks itself, so that the tasks are completed even if no
+ * thread can be started */
+void worker_pool_run(worker_task_t tasks[],
+               uint32_t num_tasks);
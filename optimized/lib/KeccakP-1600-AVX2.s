@@ -1150,3 +1150,6 @@ mask6_17:
     .quad    ALLON, ALLON,     0,     0
 
 .asciz  "Keccak-1600 for AVX2, CRYPTOGAMS by <appro@openssl.org>"
+
+# non-executable stack, as for the objects compiled from C
+.section .note.GNU-stack,"",@progbits
@@ -0,0 +1,79 @@
+/**
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ''AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **/
+
+#include <string.h>
+
+#include "KeccakP-1600-times4-portable-SnP.h"
+#include "keccakf1600.h"
+
+/* the lanes are little endian, as in the SIMD256 implementation */
+#define LANE_BYTES (8)
+
+void KeccakP1600times4_InitializeAll(KeccakP1600times4_states *states)
+{
+    memset(states, 0, sizeof(KeccakP1600times4_states));
+}
+
+void KeccakP1600times4_AddBytes(KeccakP1600times4_states *states, unsigned int instanceIndex, const unsigned char *data, unsigned int offset, unsigned int length)
+{
+    for(unsigned int i = 0; i < length; i++) {
+        const unsigned int pos = offset + i;
+        states->A[pos / LANE_BYTES][instanceIndex] ^= (uint64_t)data[i] << (8 * (pos % LANE_BYTES));
+    }
+}
+
+/* instance j reads its laneCount lanes at data + j*laneOffset lanes */
+void KeccakP1600times4_AddLanesAll(KeccakP1600times4_states *states, const unsigned char *data, unsigned int laneCount, unsigned int laneOffset)
+{
+    for(unsigned int instance = 0; instance < 4; instance++) {
+        for(unsigned int i = 0; i < laneCount; i++) {
+            uint64_t lane;
+            memcpy(&lane, data + (instance * laneOffset + i) * LANE_BYTES, LANE_BYTES);
+            states->A[i][instance] ^= lane;
+        }
+    }
+}
+
+void KeccakP1600times4_PermuteAll_24rounds(KeccakP1600times4_states *states)
+{
+    uint64_t state[25];
+    for(unsigned int instance = 0; instance < 4; instance++) {
+        for(unsigned int i = 0; i < 25; i++) {
+            state[i] = states->A[i][instance];
+        }
+        KeccakF1600_StatePermute(state);
+        for(unsigned int i = 0; i < 25; i++) {
+            states->A[i][instance] = state[i];
+        }
+    }
+}
+
+void KeccakP1600times4_ExtractBytes(const KeccakP1600times4_states *states, unsigned int instanceIndex, unsigned char *data, unsigned int offset, unsigned int length)
+{
+    for(unsigned int i = 0; i < length; i++) {
+        const unsigned int pos = offset + i;
+        data[i] = (unsigned char)(states->A[pos / LANE_BYTES][instanceIndex] >> (8 * (pos % LANE_BYTES)));
+    }
+}
+
+void KeccakP1600times4_ExtractLanesAll(const KeccakP1600times4_states *states, unsigned char *data, unsigned int laneCount, unsigned int laneOffset)
+{
+    for(unsigned int instance = 0; instance < 4; instance++) {
+        for(unsigned int i = 0; i < laneCount; i++) {
+            memcpy(data + (instance * laneOffset + i) * LANE_BYTES, &states->A[i][instance], LANE_BYTES);
+        }
+    }
+}
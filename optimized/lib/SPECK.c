@@ -14,6 +14,7 @@
  *
  **/
 #include <string.h> // memcpy, memset
+#include <stddef.h> // offsetof
 #include "SPECK.h"
 #include "codes.h"
 #include "permutation.h"
@@ -25,6 +26,84 @@
 #include "sha3.h"
 #include "sort.h"
 #include "csprng_hash.h"
+#include "align.h"
+#include "worker_pool.h"
+
+/* public matrices unpacked from the public key, in the form multiplied by
+ * row_mat_mult; the ones stored expanded in the public key are not copied */
+typedef struct {
+#ifndef SPECK_FULL_G
+    ALIGN(SPECK_WORKSPACE_ALIGN) rref_generator_mat_t G0_rref;
+#endif
+#ifdef SPECK_COMPRESS_GP
+    ALIGN(SPECK_WORKSPACE_ALIGN) rref_generator_mat_t GP_rrefs[NUM_KEYPAIRS-1];
+#endif
+#if defined(SPECK_FULL_G) && !defined(SPECK_COMPRESS_GP)
+    uint8_t unused;
+#endif
+} expanded_pk_t;
+
+/* challenge and c1s of a response, the only scratch memory of a signature
+ * once its rounds are committed */
+typedef struct {
+#ifdef SPECK_COMPRESS_C1S
+    ALIGN(SPECK_WORKSPACE_ALIGN) FQ_ELEM c1s[W][K_pad];
+#endif
+    uint8_t fixed_weight_string[T];
+    uint8_t indices_to_publish[T];
+} response_scratch_t;
+
+/* scratch memory of the signature and verification; the arrays accessed
+ * with vector loads and stores start on a cache line. The codewords are
+ * employed only by the signature which stores all of them, and are kept
+ * last, so that the other ones can employ a truncated workspace. Likewise,
+ * the digests of the rounds are stored only by the threaded computations,
+ * and come right before the codewords */
+struct speck_workspace_s {
+    ALIGN(SPECK_WORKSPACE_ALIGN) unsigned char seed_tree[NUM_NODES_SEED_TREE * SEED_LENGTH_BYTES];
+    ALIGN(SPECK_WORKSPACE_ALIGN) unsigned char rounds_seeds[T*SEED_LENGTH_BYTES];
+    ALIGN(SPECK_WORKSPACE_ALIGN) expanded_pk_t pk;
+    ALIGN(SPECK_WORKSPACE_ALIGN) response_scratch_t response;
+    uint8_t c1s_index[T];
+    ALIGN(SPECK_WORKSPACE_ALIGN) uint8_t cmt_digests[T][HASH_DIGEST_LENGTH];
+    ALIGN(SPECK_WORKSPACE_ALIGN) FQ_ELEM codewords[T][N_pad];
+};
+
+#define WORKSPACE_LOWMEM_BYTES (offsetof(speck_workspace_t, codewords))
+/* employed by the single threaded verification */
+#define WORKSPACE_VERIFY_BYTES (offsetof(speck_workspace_t, cmt_digests))
+
+size_t SPECK_workspace_bytes(void) {
+    return sizeof(speck_workspace_t);
+}
+
+size_t SPECK_workspace_lowmem_bytes(void) {
+    return WORKSPACE_LOWMEM_BYTES;
+}
+
+/* message independent part of a signature, see SPECK_bundle_precompute */
+struct speck_bundle_s {
+    ALIGN(SPECK_WORKSPACE_ALIGN) FQ_ELEM codewords[T][N_pad];
+    ALIGN(SPECK_WORKSPACE_ALIGN) FQ_ELEM histograms[T][Q];
+    ALIGN(SPECK_WORKSPACE_ALIGN) unsigned char seed_tree[NUM_NODES_SEED_TREE * SEED_LENGTH_BYTES];
+    unsigned char salt[HASH_DIGEST_LENGTH];
+    /* set by the precomputation, cleared when the bundle is used */
+    uint8_t is_fresh;
+};
+
+size_t SPECK_bundle_bytes(void) {
+    return sizeof(speck_bundle_t);
+}
+
+/* public key along with its unpacked matrices, see SPECK_prepare_pk */
+struct speck_prepared_pk_s {
+    ALIGN(SPECK_WORKSPACE_ALIGN) expanded_pk_t expanded;
+    speck_pubkey_t PK;
+};
+
+size_t SPECK_prepared_pk_bytes(void) {
+    return sizeof(speck_prepared_pk_t);
+}
 
 void SPECK_keygen(speck_prikey_t *SK,
                  speck_pubkey_t *PK) {
@@ -98,136 +177,363 @@ void SPECK_keygen(speck_prikey_t *SK,
     }
 } /* end */
 
-/// returns the number of opened seeds in the tree.
-/// \param SK[in]: secret key
-/// \param m[in]: message to sign
-/// \param mlen[in]: length of the message to sign in bytes
-/// \param sig[out]: signature
-/// \return: x: number of leaves opened by the algorithm
-size_t SPECK_sign(const speck_prikey_t *SK,
-                 const speck_pubkey_t *PK,
-                 const char *const m,
-                 const uint64_t mlen,
-                 speck_sign_t *sig) {
+/// initializes the hash states employed by the round commitments, which
+/// share the m||salt prefix: the ones of parallelism level 4 for all the
+/// groups of rounds but the last, and T mod 4 for the last one (level 3
+/// shares the x4 state)
+/// \param prefix[out]: states to be cloned by hash_par_from_prefix
+static
+void commit_prefix_init(PAR_CSPRNG_STATE_T *prefix) {
+    hash_par_prefix_init(4, prefix);
+    if (T % 4 == 1 || T % 4 == 2) {
+        hash_par_prefix_init(T % 4, prefix);
+    }
+}
+
+/// absorbs a chunk of the m||salt prefix in the round commitments states
+/// the Keccak absorbs take 32-bit lengths, larger chunks go in pieces
+static
+void commit_prefix_update(PAR_CSPRNG_STATE_T *prefix,
+                          const unsigned char *const in,
+                          const uint64_t inlen) {
+    uint64_t offset = 0;
+    while (offset < inlen) {
+        const uint32_t piece = (inlen - offset > UINT32_MAX) ?
+                               UINT32_MAX : (uint32_t) (inlen - offset);
+        hash_par_prefix_update(4, prefix, in + offset, piece);
+        if (T % 4 == 1 || T % 4 == 2) {
+            hash_par_prefix_update(T % 4, prefix, in + offset, piece);
+        }
+        offset += piece;
+    }
+}
+
+/* work unit for the commitment rounds of a signature: the rounds in
+ * [round_start, round_end) are expanded into codewords and hashed, the
+ * resulting digests are stored in cmt_digests starting from index 0 */
+typedef struct {
+    /* if NULL, the codewords are discarded once hashed */
+    FQ_ELEM (*codewords)[N_pad];
+    uint8_t (*cmt_digests)[HASH_DIGEST_LENGTH];
+    /* if not NULL, the histograms of the rounds are taken from here and the
+     * codewords are not computed */
+    const FQ_ELEM (*histograms)[Q];
+    const unsigned char *rounds_seeds;
+    /* if not NULL, the seeds of the rounds are taken in order from this walk
+     * of the seed tree instead of rounds_seeds; single threaded only */
+    ggm_walk_t *leaves;
+    const unsigned char *salt;
+    const FQ_ELEM (*G0)[K_pad];
+    /* hash states with m||salt already absorbed */
+    const PAR_CSPRNG_STATE_T *cmt_prefix;
+    uint32_t round_start;
+    uint32_t round_end;
+} sign_rounds_job_t;
+
+/// computes the codeword of a signature round from its seed
+static inline
+void expand_round_codeword(FQ_ELEM codeword[N_pad],
+                           const unsigned char round_seed[SEED_LENGTH_BYTES],
+                           const unsigned char salt[HASH_DIGEST_LENGTH],
+                           const uint16_t round_idx,
+                           const FQ_ELEM G0[K][K_pad]) {
+    word_sample_salt(codeword, round_seed, salt, round_idx);
+
+    row_mat_mult(codeword+K,codeword,G0,K,K); // Last K elements
+}
+
+/// computes the commitment inputs of up to 4 rounds, i.e., the histograms
+/// of the codewords c1 || c1*M. When 4 rounds share the same matrix, they
+/// are multiplied together, and the products are counted strip by strip
+/// as they are computed
+/// \param mset[out]: histograms, Q elements each
+/// \param c2[out]: products, K_pad elements each
+/// \param c1[in]: vectors, K elements each
+/// \param M[in]: matrix of each round
+/// \param num_rounds[in]: number of rounds, at most 4
+static inline
+void rounds_histograms(FQ_ELEM *const mset[4],
+                       FQ_ELEM *const c2[4],
+                       const FQ_ELEM *const c1[4],
+                       const FQ_ELEM (*const M[4])[K_pad],
+                       const uint32_t num_rounds) {
+    if (num_rounds == 4 && M[0] == M[1] && M[0] == M[2] && M[0] == M[3]) {
+        for (uint32_t j = 0; j < 4; j++) {
+            histogram(mset[j],c1[j],K);
+        }
+        row_mat_mult_x4_histogram(c2,mset,c1,M[0],K,K);
+    } else {
+        for (uint32_t j = 0; j < num_rounds; j++) {
+            row_mat_mult(c2[j],c1[j],M[j],K,K);
+            histogram_c1_c2(mset[j],c1[j],c2[j],K);
+        }
+    }
+}
+
+/// samples the vectors u of up to 4 rounds from their seeds, as
+/// word_sample_salt; two or more rounds are sampled with the x4 XOF, its
+/// unused instances computing a copy of the first round
+/// \param u[out]: vectors, K elements each
+/// \param round_seed[in]: seed of each round
+/// \param round_idx[in]: index of each round
+/// \param num_rounds[in]: number of rounds, at most 4
+static inline
+void sample_rounds_words(FQ_ELEM *const u[4],
+                         const unsigned char *const round_seed[4],
+                         const unsigned char salt[HASH_DIGEST_LENGTH],
+                         const uint16_t round_idx[4],
+                         const uint32_t num_rounds) {
+    if (num_rounds == 0) {
+        return;
+    }
+    if (num_rounds == 1) {
+        word_sample_salt(u[0],
+                         round_seed[0],
+                         salt,
+                         round_idx[0]);
+        return;
+    }
+    FQ_ELEM unused_u[K];
+    FQ_ELEM *lane_u[4];
+    const unsigned char *lane_seed[4];
+    uint16_t lane_idx[4];
+    for (uint32_t j = 0; j < 4; j++) {
+        const uint32_t round = j < num_rounds ? j : 0;
+        lane_u[j] = j < num_rounds ? u[j] : unused_u;
+        lane_seed[j] = round_seed[round];
+        lane_idx[j] = round_idx[round];
+    }
+    word_sample_salt_x4(lane_u, lane_seed, salt, lane_idx);
+}
+
+/// computes the codewords of the up to 4 rounds starting from round_idx
+/// from their seeds, as expand_round_codeword, and their histograms
+static inline
+void expand_rounds_codewords(FQ_ELEM *const codewords[4],
+                             FQ_ELEM *const mset[4],
+                             const unsigned char *const round_seed[4],
+                             const unsigned char salt[HASH_DIGEST_LENGTH],
+                             const uint16_t round_idx,
+                             const uint32_t num_rounds,
+                             const FQ_ELEM G0[K][K_pad]) {
+    FQ_ELEM *c2[4];
+    const FQ_ELEM *c1[4];
+    const FQ_ELEM (*M[4])[K_pad];
+    uint16_t rounds_idx[4];
+    for (uint32_t j = 0; j < num_rounds; j++) {
+        rounds_idx[j] = round_idx + j;
+    }
+    sample_rounds_words(codewords, round_seed, salt, rounds_idx, num_rounds);
+    for (uint32_t j = 0; j < num_rounds; j++) {
+        c1[j] = codewords[j];
+        c2[j] = codewords[j] + K; // Last K elements
+        M[j] = G0;
+    }
+    rounds_histograms(mset,c2,c1,M,num_rounds);
+}
+
+/// NOTE: round_start must be a multiple of 4, so that the rounds are hashed
+/// in the same groups as in the single threaded computation
+/// \param job[in/out]: rounds to compute, see sign_rounds_job_t
+static
+void sign_commit_rounds(const sign_rounds_job_t *job) {
+    FQ_ELEM cmt_i_input_buffer[4][Q];
+    FQ_ELEM *const mset[4] = {cmt_i_input_buffer[0], cmt_i_input_buffer[1],
+                              cmt_i_input_buffer[2], cmt_i_input_buffer[3]};
+    /* unused lanes of a partial group still point to valid memory */
+    const FQ_ELEM *cmt_i_input[4] = {cmt_i_input_buffer[0], cmt_i_input_buffer[1],
+                                     cmt_i_input_buffer[2], cmt_i_input_buffer[3]};
+    uint16_t cmt_i_dsc_buffer[4];
+    uint8_t cmt_i_digest_buffer[4][HASH_DIGEST_LENGTH];
 
-    /*         Private key expansion        */
-    SHAKE_STATE_STRUCT sk_shake_state;
-    initialize_csprng(&sk_shake_state, SK->sk_seed, PRIVATE_KEY_SEED_LENGTH_BYTES);
+    FQ_ELEM round_codewords[4][N_pad];
+    unsigned char leaves_buffer[4][SEED_LENGTH_BYTES];
+
+    for (uint32_t i = job->round_start; i < job->round_end; i += 4) {
+        const uint32_t buffer_len = (i + 4 < job->round_end) ? 4 : job->round_end - i;
+
+        if (job->histograms != NULL) {
+            for (uint32_t j = 0; j < buffer_len; j++) {
+                cmt_i_input[j] = job->histograms[i+j];
+            }
+        } else {
+            FQ_ELEM *codewords[4];
+            const unsigned char *round_seed[4];
+            if (job->leaves != NULL) {
+                GGMLeavesNext(job->leaves, leaves_buffer);
+            }
+            for (uint32_t j = 0; j < buffer_len; j++) {
+                codewords[j] = job->codewords != NULL ? job->codewords[i+j] : round_codewords[j];
+                round_seed[j] = job->leaves != NULL ? leaves_buffer[j] :
+                                job->rounds_seeds + (i+j) * SEED_LENGTH_BYTES;
+            }
+            expand_rounds_codewords(codewords, mset, round_seed, job->salt, i, buffer_len, job->G0);
+        }
 
-    /* Generating seed for public code G_0 (obtained from sk_seed) */
-    unsigned char G_0_seed[SEED_LENGTH_BYTES];
-    csprng_randombytes(G_0_seed, SEED_LENGTH_BYTES, &sk_shake_state);
+        for (uint32_t j = 0; j < buffer_len; j++) {
+            cmt_i_dsc_buffer[j] = HASH_DOMAIN_SEP_CONST + i + j;
+        }
 
+        hash_par_from_prefix(
+            buffer_len,
+            job->cmt_prefix,
+            cmt_i_digest_buffer[0],
+            cmt_i_digest_buffer[1],
+            cmt_i_digest_buffer[2],
+            cmt_i_digest_buffer[3],
+            cmt_i_input[0],
+            cmt_i_input[1],
+            cmt_i_input[2],
+            cmt_i_input[3],
+            sizeof(FQ_ELEM)*Q,
+            cmt_i_dsc_buffer[0],
+            cmt_i_dsc_buffer[1],
+            cmt_i_dsc_buffer[2],
+            cmt_i_dsc_buffer[3]
+        );
+        memcpy(job->cmt_digests[i - job->round_start],cmt_i_digest_buffer,buffer_len*HASH_DIGEST_LENGTH);
+    }
+}
+
+static
+void sign_commit_rounds_task(void *job) {
+    sign_commit_rounds((const sign_rounds_job_t *) job);
+}
+
+/// draws the salt and the seed tree of a signature, and expands the seeds
+/// of the rounds
+static
+void sign_sample_seeds(unsigned char salt[HASH_DIGEST_LENGTH],
+                       unsigned char seed_tree[NUM_NODES_SEED_TREE * SEED_LENGTH_BYTES],
+                       unsigned char rounds_seeds[T*SEED_LENGTH_BYTES]) {
     // generate the salt from a TRNG
-    randombytes(sig->salt, HASH_DIGEST_LENGTH);
+    randombytes(salt, HASH_DIGEST_LENGTH);
 
     /*         Ephemeral permutations generation        */
     unsigned char ephem_permutations_seed[SEED_LENGTH_BYTES];
     randombytes(ephem_permutations_seed, SEED_LENGTH_BYTES);
 
-    unsigned char seed_tree[NUM_NODES_SEED_TREE * SEED_LENGTH_BYTES] = {0};
-    BuildGGM(seed_tree, ephem_permutations_seed, sig->salt);
-    //gen_seed_tree(seed_tree, ephem_permutations_seed, sig->salt);
-
-    unsigned char linearized_rounds_seeds[T*SEED_LENGTH_BYTES] = {0};
-    seed_leaves(linearized_rounds_seeds,seed_tree);
+    memset(seed_tree, 0, NUM_NODES_SEED_TREE * SEED_LENGTH_BYTES);
+    BuildGGM(seed_tree, ephem_permutations_seed, salt);
+    //gen_seed_tree(seed_tree, ephem_permutations_seed, salt);
 
-    // FINO A QUI È TUTTO UGUALE!
+    seed_leaves(rounds_seeds,seed_tree);
+}
 
-    /*         Public G_0 expansion                  */
+/// \return the non-pivot columns of the RREF of G_0, expanded in pk if
+///         not stored as they are in PK
+static
+const FQ_ELEM (*sign_expand_G0(const speck_prikey_t *SK,
+                               const speck_pubkey_t *PK,
+                               expanded_pk_t *pk))[K_pad] {
     #ifdef SPECK_RESAMPLE_G
-        rref_generator_mat_t G0_rref;
-        generator_sample(&G0_rref, G_0_seed);
+        /*         Private key expansion        */
+        SHAKE_STATE_STRUCT sk_shake_state;
+        initialize_csprng(&sk_shake_state, SK->sk_seed, PRIVATE_KEY_SEED_LENGTH_BYTES);
+
+        /* Generating seed for public code G_0 (obtained from sk_seed) */
+        unsigned char G_0_seed[SEED_LENGTH_BYTES];
+        csprng_randombytes(G_0_seed, SEED_LENGTH_BYTES, &sk_shake_state);
+
+        generator_sample(&pk->G0_rref, G_0_seed);
+    #else
+        (void) SK;
     #endif
     #ifdef SPECK_COMPRESS_G
-        rref_generator_mat_t G0_rref;
-        expand_to_rref_speck(&G0_rref,PK->G_0_rref);
+        expand_to_rref_speck(&pk->G0_rref,PK->G_0_rref);
     #endif
 
-    FQ_ELEM x[Q];
-    FQ_ELEM codewords[T][N_pad];
-
+    #ifdef SPECK_FULL_G
+        (void) pk;
+        return (const FQ_ELEM (*)[K_pad]) PK->G_0_rref;
+    #else
+        (void) PK;
+        return (const FQ_ELEM (*)[K_pad]) pk->G0_rref.values;
+    #endif
+}
+
+/// computes the commitment rounds of job, from round 0 to T, and their
+/// digest; the salt is absorbed in the states of job->cmt_prefix
+/// \param cmt_digests[out]: storage for the T round digests, if threaded
+/// \param digest[out]: digest of the commitments
+static
+void sign_commit(sign_rounds_job_t *job,
+                 PAR_CSPRNG_STATE_T *cmt_prefix,
+                 uint32_t num_threads,
+                 uint8_t cmt_digests[T][HASH_DIGEST_LENGTH],
+                 uint8_t digest[HASH_DIGEST_LENGTH]) {
     LESS_SHA3_INC_CTX state_cmt;
     LESS_SHA3_INC_INIT(&state_cmt);
-    /*
-    LESS_SHA3_INC_CTX state_cmt_i;
-    LESS_SHA3_INC_CTX state_cmt_base;
-    LESS_SHA3_INC_INIT(&state_cmt_base);
-    LESS_SHA3_INC_ABSORB(&state_cmt_base, (const uint8_t *)m, mlen);
-    LESS_SHA3_INC_ABSORB(&state_cmt_base, sig->salt, HASH_DIGEST_LENGTH);
-    */
-
-    uint8_t cmt_i_input_buffer[4][mlen + HASH_DIGEST_LENGTH + sizeof(FQ_ELEM)*Q];
-    uint16_t cmt_i_dsc_buffer[4];
-    uint8_t cmt_i_digest_buffer[4][HASH_DIGEST_LENGTH];
-    uint8_t buffer_len = 0;
 
-    for(int8_t i = 0; i < 4; i++){
-        memcpy(cmt_i_input_buffer[i],m,mlen);
-        memcpy(cmt_i_input_buffer[i] + mlen,sig->salt,HASH_DIGEST_LENGTH);
+    commit_prefix_update(cmt_prefix, job->salt, HASH_DIGEST_LENGTH);
+    job->cmt_prefix = cmt_prefix;
+
+    /* rounds are handed out in multiples of 4, i.e., the hash_par width */
+    const uint32_t max_threads = (T+3)/4;
+    if (num_threads > max_threads) {
+        num_threads = max_threads;
     }
 
-    for (uint32_t i = 0; i < T; i++) {
-        word_sample_salt(codewords[i],
-                         linearized_rounds_seeds + i * SEED_LENGTH_BYTES,
-                         sig->salt,
-                         i);
-                                                
-        row_mat_mult(codewords[i]+K,codewords[i],
-            #ifdef SPECK_FULL_G
-                PK->G_0_rref,
-            #else
-                G0_rref.values,
-            #endif
-                K,K); // Last K elements
-                                                
-        histogram(x,codewords[i],N);
-
-        memcpy(cmt_i_input_buffer[buffer_len] + mlen + HASH_DIGEST_LENGTH, x, sizeof(FQ_ELEM)*Q);   
-        cmt_i_dsc_buffer[buffer_len] = HASH_DOMAIN_SEP_CONST + i;
-        buffer_len += 1;
-
-        if(buffer_len == 4 || i == T-1){
-            hash_par(
-                buffer_len,
-                cmt_i_digest_buffer[0],
-                cmt_i_digest_buffer[1],
-                cmt_i_digest_buffer[2],
-                cmt_i_digest_buffer[3],
-                cmt_i_input_buffer[0],
-                cmt_i_input_buffer[1],
-                cmt_i_input_buffer[2],
-                cmt_i_input_buffer[3],
-                mlen + HASH_DIGEST_LENGTH + sizeof(FQ_ELEM)*Q,
-                cmt_i_dsc_buffer[0],
-                cmt_i_dsc_buffer[1],
-                cmt_i_dsc_buffer[2],
-                cmt_i_dsc_buffer[3]
-            );
-
-            for(int j = 0; j < buffer_len; j++){
+    if (num_threads <= 1) {
+        uint8_t cmt_i_digest_buffer[4][HASH_DIGEST_LENGTH];
+        job->cmt_digests = cmt_i_digest_buffer;
+        for (uint32_t i = 0; i < T; i += 4) {
+            job->round_start = i;
+            job->round_end = (i + 4 < T) ? i + 4 : T;
+            sign_commit_rounds(job);
+
+            for(uint32_t j = 0; j < job->round_end - job->round_start; j++){
                 LESS_SHA3_INC_ABSORB(&state_cmt,cmt_i_digest_buffer[j],HASH_DIGEST_LENGTH);
             }
-
-            buffer_len = 0;
+        }
+    } else {
+        sign_rounds_job_t jobs[num_threads];
+        worker_task_t tasks[num_threads];
+
+        const uint32_t rounds_per_thread = NEXT_MULTIPLE((T + num_threads - 1)/num_threads, 4);
+        for (uint32_t t = 0; t < num_threads; t++) {
+            jobs[t] = *job;
+            jobs[t].round_start = t*rounds_per_thread < T ? t*rounds_per_thread : T;
+            jobs[t].round_end = (t+1)*rounds_per_thread < T ? (t+1)*rounds_per_thread : T;
+            jobs[t].cmt_digests = cmt_digests + jobs[t].round_start;
+            tasks[t].run = sign_commit_rounds_task;
+            tasks[t].arg = &jobs[t];
         }
 
-        /*
-        memcpy(&state_cmt_i,&state_cmt_base,sizeof(state_cmt_base));
-        LESS_SHA3_INC_ABSORB(&state_cmt_i, x, sizeof(FQ_ELEM)*Q);
-        LESS_SHA3_INC_ABSORB(&state_cmt_i, (const uint8_t *)&i, sizeof(uint16_t));
-        LESS_SHA3_INC_FINALIZE(cmt_i, &state_cmt_i);
-        LESS_SHA3_INC_ABSORB(&state_cmt, cmt_i, HASH_DIGEST_LENGTH);
-        */
+        /* the calling thread takes care of the first chunk, the persistent
+         * workers of the other ones */
+        worker_pool_run(tasks, num_threads);
+
+        for (uint32_t i = 0; i < T; i++) {
+            LESS_SHA3_INC_ABSORB(&state_cmt,cmt_digests[i],HASH_DIGEST_LENGTH);
+        }
     }
 
-    LESS_SHA3_INC_FINALIZE(sig->digest, &state_cmt);
+    LESS_SHA3_INC_FINALIZE(digest, &state_cmt);
+}
 
+/// samples the challenge from sig->digest and computes the response, i.e.,
+/// the published seeds and the c1s gathered from the challenged codewords
+/// \param seed_tree[in]: seed tree; if NULL, the published seeds and the ones
+///                       of the challenged rounds are expanded from root_seed
+/// \param codewords[in]: codewords of the rounds; if NULL, the challenged
+///                       ones are recomputed from their seeds and G0
+/// \param scratch[out]: challenge and c1s
+/// \return: x: number of leaves opened by the algorithm
+static
+size_t sign_respond(const speck_prikey_t *SK,
+                    speck_sign_t *sig,
+                    const unsigned char seed_tree[NUM_NODES_SEED_TREE * SEED_LENGTH_BYTES],
+                    const unsigned char root_seed[SEED_LENGTH_BYTES],
+                    const FQ_ELEM (*codewords)[N_pad],
+                    const unsigned char *rounds_seeds,
+                    const FQ_ELEM (*G0)[K_pad],
+                    response_scratch_t *scratch) {
     // (b_0, ..., b_{t-1})
-    uint8_t fixed_weight_string[T];
+    uint8_t *fixed_weight_string = scratch->fixed_weight_string;
     SampleChallenge(fixed_weight_string, sig->digest);
 
-    uint8_t indices_to_publish[T];
+    uint8_t *indices_to_publish = scratch->indices_to_publish;
     for (uint32_t i = 0; i < T; i++) {
         indices_to_publish[i] = !!(fixed_weight_string[i]);
     }
@@ -235,23 +541,47 @@ size_t SPECK_sign(const speck_prikey_t *SK,
     int emitted_perms = 0;
     memset(&sig->seed_storage, 0, SEED_TREE_MAX_PUBLISHED_BYTES);
 
-    const uint32_t num_seeds_published = 
-        GGMPath(seed_tree,indices_to_publish,(unsigned char *) &sig->seed_storage);
-        //seed_path((unsigned char *) &sig->seed_storage, seed_tree, indices_to_publish);
+    /* seeds of the challenged rounds, in order, when there is no tree */
+    unsigned char challenged_seeds[W][SEED_LENGTH_BYTES];
+    uint32_t num_seeds_published;
+    if (seed_tree != NULL) {
+        num_seeds_published =
+            GGMPath(seed_tree,indices_to_publish,(unsigned char *) &sig->seed_storage);
+            //seed_path((unsigned char *) &sig->seed_storage, seed_tree, indices_to_publish);
+    } else {
+        num_seeds_published =
+            GGMPathFromRoot(root_seed, sig->salt, indices_to_publish,
+                            (unsigned char *) &sig->seed_storage,
+                            (unsigned char *) challenged_seeds);
+    }
 
     #ifdef SPECK_COMPRESS_C1S
-        FQ_ELEM c1s[W][K_pad];
+        FQ_ELEM (*c1s)[K_pad] = scratch->c1s;
     #endif
 
+    FQ_ELEM round_codeword[N_pad];
     for (uint32_t i = 0; i < T; i++) {
         if (fixed_weight_string[i] != 0) {
             const int perm_num = fixed_weight_string[i];
 
+            /* the challenged codewords are recomputed, if not stored */
+            const FQ_ELEM *codeword = round_codeword;
+            if (codewords != NULL) {
+                codeword = codewords[i];
+            } else {
+                expand_round_codeword(round_codeword,
+                                      seed_tree != NULL ? rounds_seeds + i * SEED_LENGTH_BYTES :
+                                                          challenged_seeds[emitted_perms],
+                                      sig->salt,
+                                      i,
+                                      G0);
+            }
+
             for(uint8_t j = 0; j<K; j++){
                 #ifdef SPECK_COMPRESS_C1S
-                    c1s[emitted_perms][j] = codewords[i][SK->permutations[perm_num-1][j]];
+                    c1s[emitted_perms][j] = codeword[SK->permutations[perm_num-1][j]];
                 #else
-                    sig->c1s[emitted_perms][j] = codewords[i][SK->permutations[perm_num-1][j]];
+                    sig->c1s[emitted_perms][j] = codeword[SK->permutations[perm_num-1][j]];
                 #endif
             }
 
@@ -262,178 +592,711 @@ size_t SPECK_sign(const speck_prikey_t *SK,
         compress_c1s(sig->c1s,c1s);
     #endif
     return num_seeds_published;
+}
+
+/// computes the signature given the round commitments states in which the
+/// message has been absorbed
+/// \param cmt_prefix[in/out]: states, the salt is appended to them
+/// \param G0[in]: non-pivot columns of G_0, see sign_expand_G0
+/// \param store_codewords[in]: if 0, see SPECK_sign_lowmem_ws
+static
+size_t sign_from_prefix(const speck_prikey_t *SK,
+                        PAR_CSPRNG_STATE_T *cmt_prefix,
+                        speck_sign_t *sig,
+                        speck_workspace_t *ws,
+                        const FQ_ELEM (*G0)[K_pad],
+                        int store_codewords,
+                        uint32_t num_threads) {
+    if (!store_codewords) {
+        /* the seeds of the rounds are streamed from a walk of the seed tree,
+         * which is not stored: the response expands again from the root the
+         * few nodes it needs */
+        randombytes(sig->salt, HASH_DIGEST_LENGTH);
+        unsigned char ephem_permutations_seed[SEED_LENGTH_BYTES];
+        randombytes(ephem_permutations_seed, SEED_LENGTH_BYTES);
+
+        ggm_walk_t leaves;
+        GGMLeavesInit(&leaves, ephem_permutations_seed, sig->salt);
+        sign_rounds_job_t job = {
+            .leaves = &leaves,
+            .salt = sig->salt,
+            .G0 = G0,
+        };
+        sign_commit(&job, cmt_prefix, 1, ws->cmt_digests, sig->digest);
+
+        return sign_respond(SK,
+                            sig,
+                            NULL,
+                            ephem_permutations_seed,
+                            NULL,
+                            NULL,
+                            job.G0,
+                            &ws->response);
+    }
+
+    sign_sample_seeds(sig->salt, ws->seed_tree, ws->rounds_seeds);
+
+    sign_rounds_job_t job = {
+        .codewords = ws->codewords,
+        .rounds_seeds = ws->rounds_seeds,
+        .salt = sig->salt,
+        .G0 = G0,
+    };
+    sign_commit(&job, cmt_prefix, num_threads, ws->cmt_digests, sig->digest);
+
+    return sign_respond(SK,
+                        sig,
+                        ws->seed_tree,
+                        NULL,
+                        (const FQ_ELEM (*)[N_pad]) job.codewords,
+                        ws->rounds_seeds,
+                        job.G0,
+                        &ws->response);
+} /* end sign_from_prefix */
+
+/// returns the number of opened seeds in the tree.
+/// \param SK[in]: secret key
+/// \param m[in]: message to sign
+/// \param mlen[in]: length of the message to sign in bytes
+/// \param sig[out]: signature
+/// \return: x: number of leaves opened by the algorithm
+size_t SPECK_sign(const speck_prikey_t *SK,
+                 const speck_pubkey_t *PK,
+                 const char *const m,
+                 const uint64_t mlen,
+                 speck_sign_t *sig) {
+    return SPECK_sign_mt(SK, PK, m, mlen, sig, 1);
 } /* end SPECK_sign */
 
-/// NOTE: non-constant time
+/// same as SPECK_sign, the T commitment rounds are split in contiguous
+/// chunks among num_threads threads (the calling one included). The round
+/// digests are absorbed in round order, thus the signature is bit-identical
+/// to the one computed by SPECK_sign.
+/// \param num_threads[in]: number of threads computing the rounds
+size_t SPECK_sign_mt(const speck_prikey_t *SK,
+                 const speck_pubkey_t *PK,
+                 const char *const m,
+                 const uint64_t mlen,
+                 speck_sign_t *sig,
+                 uint32_t num_threads) {
+    speck_workspace_t ws;
+    return SPECK_sign_mt_ws(SK, PK, m, mlen, sig, num_threads, &ws);
+} /* end SPECK_sign_mt */
+
+/// same as SPECK_sign_mt, employing the caller provided scratch memory
+/// instead of the stack
+/// \param ws[in/out]: workspace, see SPECK_workspace_bytes
+size_t SPECK_sign_mt_ws(const speck_prikey_t *SK,
+                        const speck_pubkey_t *PK,
+                        const char *const m,
+                        const uint64_t mlen,
+                        speck_sign_t *sig,
+                        uint32_t num_threads,
+                        speck_workspace_t *ws) {
+    speck_sign_ctx_t ctx;
+    SPECK_sign_init(&ctx);
+    SPECK_sign_update(&ctx, m, mlen);
+    return sign_from_prefix(SK, &ctx.cmt_prefix, sig, ws, sign_expand_G0(SK, PK, &ws->pk), 1, num_threads);
+} /* end SPECK_sign_mt_ws */
+
+/// starts the signature of a message provided in chunks
+/// \param ctx[out]: signing context
+void SPECK_sign_init(speck_sign_ctx_t *ctx) {
+    commit_prefix_init(&ctx->cmt_prefix);
+} /* end SPECK_sign_init */
+
+/// \param ctx[in/out]: signing context
+/// \param m[in]: next chunk of the message to sign
+/// \param mlen[in]: length of the chunk in bytes
+void SPECK_sign_update(speck_sign_ctx_t *ctx,
+                       const char *const m,
+                       const uint64_t mlen) {
+    commit_prefix_update(&ctx->cmt_prefix, (const unsigned char *) m, mlen);
+} /* end SPECK_sign_update */
+
+/// computes the signature of the message absorbed in ctx, which is left
+/// untouched and can be further updated
+/// \param SK[in]: secret key
 /// \param PK[in]: public key
-/// \param m[in]: message for which a signature was computed
-/// \param mlen[in]: length of the message in bytes
-/// \param sig[in]: signature
-/// \return 0: on failure
-///         1: on success
-int SPECK_verify(const speck_pubkey_t *const PK,
-                const char *const m,
-                const uint64_t mlen,
-                const speck_sign_t *const sig) {
-    uint8_t fixed_weight_string[T] = {0};
-    SampleChallenge(fixed_weight_string, sig->digest);
+/// \param ctx[in]: signing context
+/// \param sig[out]: signature
+/// \return: x: number of leaves opened by the algorithm
+size_t SPECK_sign_final(const speck_prikey_t *SK,
+                        const speck_pubkey_t *PK,
+                        const speck_sign_ctx_t *ctx,
+                        speck_sign_t *sig) {
+    speck_workspace_t ws;
+    return SPECK_sign_final_ws(SK, PK, ctx, sig, &ws);
+} /* end SPECK_sign_final */
+
+/// same as SPECK_sign_final, employing the caller provided scratch memory
+/// instead of the stack
+/// \param ws[in/out]: workspace, see SPECK_workspace_bytes
+size_t SPECK_sign_final_ws(const speck_prikey_t *SK,
+                           const speck_pubkey_t *PK,
+                           const speck_sign_ctx_t *ctx,
+                           speck_sign_t *sig,
+                           speck_workspace_t *ws) {
+    PAR_CSPRNG_STATE_T cmt_prefix = ctx->cmt_prefix;
+    return sign_from_prefix(SK, &cmt_prefix, sig, ws, sign_expand_G0(SK, PK, &ws->pk), 1, 1);
+} /* end SPECK_sign_final_ws */
+
+/// same as SPECK_sign, employing the caller provided scratch memory instead
+/// of the stack
+/// \param ws[in/out]: workspace, see SPECK_workspace_bytes
+size_t SPECK_sign_ws(const speck_prikey_t *SK,
+                     const speck_pubkey_t *PK,
+                     const char *const m,
+                     const uint64_t mlen,
+                     speck_sign_t *sig,
+                     speck_workspace_t *ws) {
+    return SPECK_sign_mt_ws(SK, PK, m, mlen, sig, 1, ws);
+} /* end SPECK_sign_ws */
+
+/// same as SPECK_sign_ws, without storing the T codewords: the W challenged
+/// ones are recomputed once the challenge is known, trading W codeword
+/// expansions for T*N_pad bytes of memory. Neither the seed tree nor the
+/// round seeds are stored either: the rounds take their seeds from a
+/// depth-first walk of the tree, and the response expands again from the
+/// root the ancestors of the challenged rounds
+/// \param ws[in/out]: workspace of at least SPECK_workspace_lowmem_bytes()
+size_t SPECK_sign_lowmem_ws(const speck_prikey_t *SK,
+                            const speck_pubkey_t *PK,
+                            const char *const m,
+                            const uint64_t mlen,
+                            speck_sign_t *sig,
+                            speck_workspace_t *ws) {
+    speck_sign_ctx_t ctx;
+    SPECK_sign_init(&ctx);
+    SPECK_sign_update(&ctx, m, mlen);
+    return sign_from_prefix(SK, &ctx.cmt_prefix, sig, ws, sign_expand_G0(SK, PK, &ws->pk), 0, 1);
+} /* end SPECK_sign_lowmem_ws */
+
+/// signs num_msgs messages, the signatures being the same as the ones of
+/// num_msgs calls to SPECK_sign, in order. A convenience wrapper: the
+/// messages are signed one at a time, at the cost of the separate calls;
+/// only G_0, if not stored in PK, is expanded once for all of them
+/// \param msgs[in]: messages to sign
+/// \param lens[in]: lengths of the messages in bytes
+/// \param sigs[out]: signatures
+/// \param num_msgs[in]: number of messages
+void SPECK_sign_batch(const speck_prikey_t *SK,
+                      const speck_pubkey_t *PK,
+                      const char *const msgs[],
+                      const uint64_t lens[],
+                      speck_sign_t sigs[],
+                      const uint32_t num_msgs) {
+    speck_workspace_t ws;
+    SPECK_sign_batch_ws(SK, PK, msgs, lens, sigs, num_msgs, &ws);
+} /* end SPECK_sign_batch */
+
+/// same as SPECK_sign_batch, employing the caller provided scratch memory
+/// instead of the stack
+/// \param ws[in/out]: workspace, see SPECK_workspace_bytes
+void SPECK_sign_batch_ws(const speck_prikey_t *SK,
+                         const speck_pubkey_t *PK,
+                         const char *const msgs[],
+                         const uint64_t lens[],
+                         speck_sign_t sigs[],
+                         const uint32_t num_msgs,
+                         speck_workspace_t *ws) {
+    const FQ_ELEM (*G0)[K_pad] = sign_expand_G0(SK, PK, &ws->pk);
+
+    for (uint32_t i = 0; i < num_msgs; i++) {
+        speck_sign_ctx_t ctx;
+        SPECK_sign_init(&ctx);
+        SPECK_sign_update(&ctx, msgs[i], lens[i]);
+        sign_from_prefix(SK, &ctx.cmt_prefix, &sigs[i], ws, G0, 1, 1);
+    }
+} /* end SPECK_sign_batch_ws */
 
-    uint8_t published_seed_indexes[T];
-    for (uint32_t i = 0; i < T; i++) {
-        published_seed_indexes[i] = !!(fixed_weight_string[i]);
+/// computes the message independent part of a signature: salt, seed tree,
+/// codewords and their histograms
+/// \param SK[in]: secret key
+/// \param PK[in]: public key
+/// \param bundle[out]: bundle, to be used by a single SPECK_sign_with_bundle
+void SPECK_bundle_precompute(const speck_prikey_t *SK,
+                             const speck_pubkey_t *PK,
+                             speck_bundle_t *bundle) {
+    unsigned char salt[HASH_DIGEST_LENGTH];
+    unsigned char ephem_permutations_seed[SEED_LENGTH_BYTES];
+    randombytes(salt, HASH_DIGEST_LENGTH);
+    randombytes(ephem_permutations_seed, SEED_LENGTH_BYTES);
+
+    SPECK_bundle_precompute_seeded(SK, PK, salt, ephem_permutations_seed, bundle);
+} /* end SPECK_bundle_precompute */
+
+/// same as SPECK_bundle_precompute, with the randomness provided by the
+/// caller, e.g., drawn under a lock when the global CSPRNG is shared
+/// \param salt[in]: salt of the signature
+/// \param ephem_permutations_seed[in]: root of the seed tree
+void SPECK_bundle_precompute_seeded(const speck_prikey_t *SK,
+                                    const speck_pubkey_t *PK,
+                                    const unsigned char salt[HASH_DIGEST_LENGTH],
+                                    const unsigned char ephem_permutations_seed[SEED_LENGTH_BYTES],
+                                    speck_bundle_t *bundle) {
+    memcpy(bundle->salt, salt, HASH_DIGEST_LENGTH);
+    memset(bundle->seed_tree, 0, NUM_NODES_SEED_TREE * SEED_LENGTH_BYTES);
+    BuildGGM(bundle->seed_tree, ephem_permutations_seed, bundle->salt);
+
+    /* the seeds of the rounds are read from the leaves of the stored tree,
+     * and G_0 is expanded, if needed, in the only scratch memory */
+    ALIGN(SPECK_WORKSPACE_ALIGN) expanded_pk_t pk;
+    const FQ_ELEM (*G0)[K_pad] = sign_expand_G0(SK, PK, &pk);
+
+    for (uint32_t i = 0; i < T; i += 4) {
+        const uint32_t num_rounds = (i + 4 < T) ? 4 : T - i;
+        FQ_ELEM *codewords[4];
+        FQ_ELEM *mset[4];
+        const unsigned char *round_seed[4];
+        for (uint32_t j = 0; j < num_rounds; j++) {
+            codewords[j] = bundle->codewords[i+j];
+            mset[j] = bundle->histograms[i+j];
+            round_seed[j] = seed_leaf(bundle->seed_tree, i+j);
+        }
+        expand_rounds_codewords(codewords, mset, round_seed, bundle->salt, i, num_rounds, G0);
     }
+    bundle->is_fresh = 1;
+} /* end SPECK_bundle_precompute_seeded */
 
-    unsigned char seed_tree[NUM_NODES_SEED_TREE * SEED_LENGTH_BYTES] = {0};
-    uint32_t rebuilding_seeds_went_fine;
-    rebuilding_seeds_went_fine = 
-                RebuildGGM(seed_tree,published_seed_indexes,(unsigned char *) &sig->seed_storage,sig->salt);
-                //rebuild_tree(seed_tree,published_seed_indexes,(unsigned char *) &sig->seed_storage,sig->salt);
-    if (!rebuilding_seeds_went_fine) {
-        return -1;
+/// signs employing a precomputed bundle, which is erased: only the round
+/// commitments are hashed, and the response gathered.
+/// NOTE: two signatures from the same bundle would reveal the secret key
+/// \param SK[in]: secret key
+/// \param m[in]: message to sign
+/// \param mlen[in]: length of the message to sign in bytes
+/// \param sig[out]: signature
+/// \param bundle[in/out]: bundle filled by SPECK_bundle_precompute
+/// \return: x: number of leaves opened by the algorithm, 0 if the bundle
+///           was already used and no signature was computed
+size_t SPECK_sign_with_bundle(const speck_prikey_t *SK,
+                              const char *const m,
+                              const uint64_t mlen,
+                              speck_sign_t *sig,
+                              speck_bundle_t *bundle) {
+    if (bundle->is_fresh != 1) {
+        return 0;
     }
+    bundle->is_fresh = 0;
+
+    /* the rounds are committed by the calling thread only, so that their
+     * digests are not stored, and the response is the only scratch memory */
+    response_scratch_t response;
+
+    speck_sign_ctx_t ctx;
+    SPECK_sign_init(&ctx);
+    SPECK_sign_update(&ctx, m, mlen);
+
+    memcpy(sig->salt, bundle->salt, HASH_DIGEST_LENGTH);
+    sign_rounds_job_t job = {
+        .histograms = (const FQ_ELEM (*)[Q]) bundle->histograms,
+        .salt = sig->salt,
+    };
+    sign_commit(&job, &ctx.cmt_prefix, 1, NULL, sig->digest);
+
+    const size_t num_seeds_published = sign_respond(SK,
+                                                    sig,
+                                                    bundle->seed_tree,
+                                                    NULL,
+                                                    (const FQ_ELEM (*)[N_pad]) bundle->codewords,
+                                                    NULL,
+                                                    NULL,
+                                                    &response);
+    wipe(bundle, sizeof(speck_bundle_t));
+    return num_seeds_published;
+} /* end SPECK_sign_with_bundle */
+
+
+/* work unit for the commitment rounds of a verification: the rounds in
+ * [round_start, round_end) are recomputed either from their seed, or from
+ * the published c1 through the challenged G_i, and hashed. The resulting
+ * digests are stored in cmt_digests starting from index 0 */
+typedef struct {
+    uint8_t (*cmt_digests)[HASH_DIGEST_LENGTH];
+    const uint8_t *fixed_weight_string;
+    /* index in c1s of the published codeword of each challenged round */
+    const uint8_t *c1s_index;
+    const unsigned char *rounds_seeds;
+    const unsigned char *salt;
+    const FQ_ELEM (*G0)[K_pad];
+    const FQ_ELEM (*GP[NUM_KEYPAIRS-1])[K_pad];
+    const FQ_ELEM (*c1s)[K_pad];
+    /* hash states with m||salt already absorbed */
+    const PAR_CSPRNG_STATE_T *cmt_prefix;
+    uint32_t round_start;
+    uint32_t round_end;
+} verify_rounds_job_t;
+
+/// NOTE: round_start must be a multiple of 4, so that the rounds are hashed
+/// in the same groups as in the single threaded computation
+/// \param job[in/out]: rounds to compute, see verify_rounds_job_t
+static
+void verify_commit_rounds(const verify_rounds_job_t *job) {
+    FQ_ELEM u_buffer[4][K];
+    FQ_ELEM *const u[4] = {u_buffer[0], u_buffer[1], u_buffer[2], u_buffer[3]};
+    FQ_ELEM c2_buffer[4][K_pad];
+    FQ_ELEM *const c2[4] = {c2_buffer[0], c2_buffer[1], c2_buffer[2], c2_buffer[3]};
+    FQ_ELEM cmt_i_input_buffer[4][Q];
+    FQ_ELEM *const mset[4] = {cmt_i_input_buffer[0], cmt_i_input_buffer[1],
+                              cmt_i_input_buffer[2], cmt_i_input_buffer[3]};
+    uint16_t cmt_i_dsc_buffer[4];
+    uint8_t cmt_i_digest_buffer[4][HASH_DIGEST_LENGTH];
 
-    unsigned char linearized_rounds_seeds[T*SEED_LENGTH_BYTES] = {0};
-    seed_leaves(linearized_rounds_seeds,seed_tree);
+    for (uint32_t i = job->round_start; i < job->round_end; i += 4) {
+        const uint32_t buffer_len = (i + 4 < job->round_end) ? 4 : job->round_end - i;
+        const FQ_ELEM *c1[4];
+        const FQ_ELEM (*M[4])[K_pad];
+
+        /* the unchallenged rounds of the group are sampled together */
+        FQ_ELEM *sampled_u[4];
+        const unsigned char *sampled_seed[4];
+        uint16_t sampled_idx[4];
+        uint32_t num_sampled = 0;
+        for (uint32_t j = 0; j < buffer_len; j++) {
+            if (job->fixed_weight_string[i+j] == 0) {
+                sampled_u[num_sampled] = u[j];
+                sampled_seed[num_sampled] = job->rounds_seeds + (i+j) * SEED_LENGTH_BYTES;
+                sampled_idx[num_sampled] = i+j;
+                num_sampled++;
+            }
+        }
+        sample_rounds_words(sampled_u, sampled_seed, job->salt, sampled_idx, num_sampled);
+
+        for (uint32_t j = 0; j < buffer_len; j++) {
+            if (job->fixed_weight_string[i+j] == 0) {
+                c1[j] = u[j];
+                M[j] = job->G0;
+            } else {
+                c1[j] = job->c1s[job->c1s_index[i+j]];
+                M[j] = job->GP[job->fixed_weight_string[i+j]-1];
+            }
+        }
 
-    int employed_perms = 0;
+        rounds_histograms(mset,c2,c1,M,buffer_len);
 
-    LESS_SHA3_INC_CTX state_cmt;
-    LESS_SHA3_INC_INIT(&state_cmt);
+        for (uint32_t j = 0; j < buffer_len; j++) {
+            cmt_i_dsc_buffer[j] = HASH_DOMAIN_SEP_CONST + i + j;
+        }
 
-    /*
-    LESS_SHA3_INC_CTX state_cmt_i;
-    uint8_t cmt_i[HASH_DIGEST_LENGTH];
-    */
+        hash_par_from_prefix(
+            buffer_len,
+            job->cmt_prefix,
+            cmt_i_digest_buffer[0],
+            cmt_i_digest_buffer[1],
+            cmt_i_digest_buffer[2],
+            cmt_i_digest_buffer[3],
+            cmt_i_input_buffer[0],
+            cmt_i_input_buffer[1],
+            cmt_i_input_buffer[2],
+            cmt_i_input_buffer[3],
+            sizeof(FQ_ELEM)*Q,
+            cmt_i_dsc_buffer[0],
+            cmt_i_dsc_buffer[1],
+            cmt_i_dsc_buffer[2],
+            cmt_i_dsc_buffer[3]
+        );
+        memcpy(job->cmt_digests[i - job->round_start],cmt_i_digest_buffer,buffer_len*HASH_DIGEST_LENGTH);
+    }
+}
 
-    FQ_ELEM u[K];
-    FQ_ELEM x[Q];
-    FQ_ELEM c2[K_pad];
-    
+static
+void verify_commit_rounds_task(void *job) {
+    verify_commit_rounds((const verify_rounds_job_t *) job);
+}
+
+/// unpacks the matrices of PK which are not stored expanded in it
+static
+void verify_expand_pk(expanded_pk_t *expanded, const speck_pubkey_t *const PK) {
     #ifndef SPECK_FULL_G
-        rref_generator_mat_t G0_rref;
         #ifdef SPECK_RESAMPLE_G
-            generator_sample(&G0_rref, PK->G_0_seed);
+            generator_sample(&expanded->G0_rref, PK->G_0_seed);
         #endif
         #ifdef SPECK_COMPRESS_G
-            expand_to_rref_speck(&G0_rref,PK->G_0_rref);
+            expand_to_rref_speck(&expanded->G0_rref,PK->G_0_rref);
         #endif
     #endif
 
-
     #ifdef SPECK_COMPRESS_GP
-        rref_generator_mat_t GP_rrefs[NUM_KEYPAIRS-1];
         for(int i=0; i<NUM_KEYPAIRS-1;i++){
-            expand_to_rref_speck(&GP_rrefs[i],PK->SF_G[i]);
+            expand_to_rref_speck(&expanded->GP_rrefs[i],PK->SF_G[i]);
         }
     #endif
+    (void) expanded;
+    (void) PK;
+}
+
+/// verifies the signature given the round commitments states in which the
+/// message has been absorbed. The T commitment rounds are split in
+/// contiguous chunks among num_threads threads (the calling one included).
+/// Since the position in c1s of each challenged round is computed
+/// beforehand, the chunks are independent; their digests are absorbed in
+/// round order.
+/// \param expanded[in]: matrices of PK unpacked by verify_expand_pk
+/// \param cmt_prefix[in/out]: states, the salt is appended to them
+/// \param num_threads[in]: number of threads computing the rounds
+static
+int verify_from_prefix(const speck_pubkey_t *const PK,
+                       const expanded_pk_t *expanded,
+                       PAR_CSPRNG_STATE_T *cmt_prefix,
+                       const speck_sign_t *const sig,
+                       speck_workspace_t *ws,
+                       uint32_t num_threads) {
+    uint8_t *fixed_weight_string = ws->response.fixed_weight_string;
+    SampleChallenge(fixed_weight_string, sig->digest);
 
-    #ifdef SPECK_COMPRESS_C1S
-        FQ_ELEM c1s[W][K_pad];
-        expand_c1s(c1s,sig->c1s);
-    #endif
-
-    /*
-    LESS_SHA3_INC_CTX state_cmt_base;
-    LESS_SHA3_INC_INIT(&state_cmt_base);
-    LESS_SHA3_INC_ABSORB(&state_cmt_base, (const uint8_t *)m, mlen);
-    LESS_SHA3_INC_ABSORB(&state_cmt_base, sig->salt, HASH_DIGEST_LENGTH);
-    */
-
-    uint8_t cmt_i_input_buffer[4][mlen + HASH_DIGEST_LENGTH + sizeof(FQ_ELEM)*Q];
-    uint16_t cmt_i_dsc_buffer[4];
-    uint8_t cmt_i_digest_buffer[4][HASH_DIGEST_LENGTH];
-    uint8_t buffer_len = 0;
+    uint8_t *published_seed_indexes = ws->response.indices_to_publish;
+    for (uint32_t i = 0; i < T; i++) {
+        published_seed_indexes[i] = !!(fixed_weight_string[i]);
+    }
 
-    for(int8_t i = 0; i < 4; i++){
-        memcpy(cmt_i_input_buffer[i],m,mlen);
-        memcpy(cmt_i_input_buffer[i] + mlen,sig->salt,HASH_DIGEST_LENGTH);
+    unsigned char *seed_tree = ws->seed_tree;
+    memset(seed_tree, 0, sizeof(ws->seed_tree));
+    uint32_t rebuilding_seeds_went_fine;
+    rebuilding_seeds_went_fine = 
+                RebuildGGM(seed_tree,published_seed_indexes,(unsigned char *) &sig->seed_storage,sig->salt);
+                //rebuild_tree(seed_tree,published_seed_indexes,(unsigned char *) &sig->seed_storage,sig->salt);
+    if (!rebuilding_seeds_went_fine) {
+        return -1;
     }
 
+    unsigned char *linearized_rounds_seeds = ws->rounds_seeds;
+    seed_leaves(linearized_rounds_seeds,seed_tree);
+
+    /* the i-th challenged round employs the i-th published codeword */
+    uint8_t *c1s_index = ws->c1s_index;
+    uint8_t employed_perms = 0;
     for (uint32_t i = 0; i < T; i++) {
-        if (fixed_weight_string[i] == 0) {
+        c1s_index[i] = employed_perms;
+        employed_perms += (fixed_weight_string[i] != 0);
+    }
 
-            word_sample_salt(u,
-                             linearized_rounds_seeds + i * SEED_LENGTH_BYTES,
-                             sig->salt,
-                             i);
+    LESS_SHA3_INC_CTX state_cmt;
+    LESS_SHA3_INC_INIT(&state_cmt);
 
-            #ifdef SPECK_FULL_G
-                row_mat_mult(c2,u,PK->G_0_rref,K,K);
-            #else
-                row_mat_mult(c2,u,G0_rref.values,K,K);
-            #endif
+    commit_prefix_update(cmt_prefix, sig->salt, HASH_DIGEST_LENGTH);
 
-            histogram_c1_c2(x,u,c2,K);
-        } else {
+    #ifdef SPECK_COMPRESS_C1S
+        expand_c1s(ws->response.c1s,sig->c1s);
+    #endif
 
+    verify_rounds_job_t job = {
+        .fixed_weight_string = fixed_weight_string,
+        .c1s_index = c1s_index,
+        .rounds_seeds = linearized_rounds_seeds,
+        .salt = sig->salt,
+        #ifdef SPECK_FULL_G
+            .G0 = (const FQ_ELEM (*)[K_pad]) PK->G_0_rref,
+        #else
+            .G0 = (const FQ_ELEM (*)[K_pad]) expanded->G0_rref.values,
+        #endif
+        #ifdef SPECK_COMPRESS_C1S
+            .c1s = (const FQ_ELEM (*)[K_pad]) ws->response.c1s,
+        #else
+            .c1s = (const FQ_ELEM (*)[K_pad]) sig->c1s,
+        #endif
+        .cmt_prefix = cmt_prefix,
+    };
+    for(int i=0; i<NUM_KEYPAIRS-1;i++){
+        #ifdef SPECK_COMPRESS_GP
+            job.GP[i] = (const FQ_ELEM (*)[K_pad]) expanded->GP_rrefs[i].values;
+        #else
+            job.GP[i] = (const FQ_ELEM (*)[K_pad]) PK->SF_G[i];
+        #endif
+    }
 
-            row_mat_mult(c2,
-                        #ifdef SPECK_COMPRESS_C1S
-                            c1s[employed_perms],
-                        #else
-                            sig->c1s[employed_perms],
-                        #endif
-                        #ifdef SPECK_COMPRESS_GP
-                            GP_rrefs[fixed_weight_string[i]-1].values,
-                        #else
-                            PK->SF_G[fixed_weight_string[i]-1],
-                        #endif
-                            K,K);
-
-            histogram_c1_c2(x,
-                    #ifdef SPECK_COMPRESS_C1S
-                        c1s[employed_perms],
-                    #else
-                        sig->c1s[employed_perms],
-                    #endif
-                    c2,K);
-
-            employed_perms++;
-        }
+    /* rounds are handed out in multiples of 4, i.e., the hash_par width */
+    const uint32_t max_threads = (T+3)/4;
+    if (num_threads > max_threads) {
+        num_threads = max_threads;
+    }
 
+    if (num_threads <= 1) {
+        uint8_t cmt_i_digest_buffer[4][HASH_DIGEST_LENGTH];
+        job.cmt_digests = cmt_i_digest_buffer;
+        for (uint32_t i = 0; i < T; i += 4) {
+            job.round_start = i;
+            job.round_end = (i + 4 < T) ? i + 4 : T;
+            verify_commit_rounds(&job);
 
-        memcpy(cmt_i_input_buffer[buffer_len] + mlen + HASH_DIGEST_LENGTH, x, sizeof(FQ_ELEM)*Q);   
-        cmt_i_dsc_buffer[buffer_len] = HASH_DOMAIN_SEP_CONST + i;
-        buffer_len += 1;
-
-        if(buffer_len == 4 || i == T-1){
-            hash_par(
-                buffer_len,
-                cmt_i_digest_buffer[0],
-                cmt_i_digest_buffer[1],
-                cmt_i_digest_buffer[2],
-                cmt_i_digest_buffer[3],
-                cmt_i_input_buffer[0],
-                cmt_i_input_buffer[1],
-                cmt_i_input_buffer[2],
-                cmt_i_input_buffer[3],
-                mlen + HASH_DIGEST_LENGTH + sizeof(FQ_ELEM)*Q,
-                cmt_i_dsc_buffer[0],
-                cmt_i_dsc_buffer[1],
-                cmt_i_dsc_buffer[2],
-                cmt_i_dsc_buffer[3]
-            );
-
-            for(int j = 0; j < buffer_len; j++){
+            for(uint32_t j = 0; j < job.round_end - job.round_start; j++){
                 LESS_SHA3_INC_ABSORB(&state_cmt,cmt_i_digest_buffer[j],HASH_DIGEST_LENGTH);
             }
-
-            buffer_len = 0;
+        }
+    } else {
+        uint8_t (*cmt_digests)[HASH_DIGEST_LENGTH] = ws->cmt_digests;
+        verify_rounds_job_t jobs[num_threads];
+        worker_task_t tasks[num_threads];
+
+        const uint32_t rounds_per_thread = NEXT_MULTIPLE((T + num_threads - 1)/num_threads, 4);
+        for (uint32_t t = 0; t < num_threads; t++) {
+            jobs[t] = job;
+            jobs[t].round_start = t*rounds_per_thread < T ? t*rounds_per_thread : T;
+            jobs[t].round_end = (t+1)*rounds_per_thread < T ? (t+1)*rounds_per_thread : T;
+            jobs[t].cmt_digests = cmt_digests + jobs[t].round_start;
+            tasks[t].run = verify_commit_rounds_task;
+            tasks[t].arg = &jobs[t];
         }
 
-        /*
-        memcpy(&state_cmt_i,&state_cmt_base,sizeof(state_cmt_base));
-        LESS_SHA3_INC_ABSORB(&state_cmt_i, x, sizeof(FQ_ELEM)*Q);
-        LESS_SHA3_INC_ABSORB(&state_cmt_i, (const uint8_t *)&i, sizeof(uint16_t));
-        LESS_SHA3_INC_FINALIZE(cmt_i, &state_cmt_i);
+        worker_pool_run(tasks, num_threads);
 
-        LESS_SHA3_INC_ABSORB(&state_cmt, cmt_i, HASH_DIGEST_LENGTH);
-        */
+        for (uint32_t i = 0; i < T; i++) {
+            LESS_SHA3_INC_ABSORB(&state_cmt,cmt_digests[i],HASH_DIGEST_LENGTH);
+        }
     }
 
     uint8_t cmt[HASH_DIGEST_LENGTH];
     LESS_SHA3_INC_FINALIZE(cmt, &state_cmt);
 
     return (verify(cmt, sig->digest,HASH_DIGEST_LENGTH) == 0);
+} /* end verify_from_prefix */
+
+/// NOTE: non-constant time
+/// \param PK[in]: public key
+/// \param m[in]: message for which a signature was computed
+/// \param mlen[in]: length of the message in bytes
+/// \param sig[in]: signature
+/// \return 0: on failure
+///         1: on success
+int SPECK_verify(const speck_pubkey_t *const PK,
+                const char *const m,
+                const uint64_t mlen,
+                const speck_sign_t *const sig) {
+    return SPECK_verify_mt(PK, m, mlen, sig, 1);
 } /* end SPECK_verify */
 
+/// threaded part of SPECK_verify_mt, kept out of line so that the digests
+/// of the rounds are on the stack only when employed
+/// \param cmt_prefix[in/out]: states in which the message has been absorbed
+/// \param num_threads[in]: number of threads computing the rounds
+static __attribute__((noinline))
+int verify_threaded(const speck_pubkey_t *const PK,
+                    PAR_CSPRNG_STATE_T *cmt_prefix,
+                    const speck_sign_t *const sig,
+                    uint32_t num_threads) {
+    /* the verification does not employ the codewords */
+    ALIGN(SPECK_WORKSPACE_ALIGN) unsigned char ws[WORKSPACE_LOWMEM_BYTES];
+    expanded_pk_t *expanded = &((speck_workspace_t *) ws)->pk;
+    verify_expand_pk(expanded, PK);
+    return verify_from_prefix(PK, expanded, cmt_prefix, sig, (speck_workspace_t *) ws, num_threads);
+} /* end verify_threaded */
+
+/// same as SPECK_verify, computing the T rounds with num_threads threads
+/// \param num_threads[in]: number of threads computing the rounds
+int SPECK_verify_mt(const speck_pubkey_t *const PK,
+                const char *const m,
+                const uint64_t mlen,
+                const speck_sign_t *const sig,
+                uint32_t num_threads) {
+    speck_verify_ctx_t ctx;
+    SPECK_verify_init(&ctx);
+    SPECK_verify_update(&ctx, m, mlen);
+    if (num_threads > 1) {
+        return verify_threaded(PK, &ctx.cmt_prefix, sig, num_threads);
+    }
+    /* neither the codewords nor the digests of the rounds are employed */
+    ALIGN(SPECK_WORKSPACE_ALIGN) unsigned char ws[WORKSPACE_VERIFY_BYTES];
+    expanded_pk_t *expanded = &((speck_workspace_t *) ws)->pk;
+    verify_expand_pk(expanded, PK);
+    return verify_from_prefix(PK, expanded, &ctx.cmt_prefix, sig, (speck_workspace_t *) ws, 1);
+} /* end SPECK_verify_mt */
+
+/// same as SPECK_verify_mt, employing the caller provided scratch memory
+/// instead of the stack
+/// \param ws[in/out]: workspace of at least SPECK_workspace_lowmem_bytes()
+///                    bytes, as the codewords are not employed
+int SPECK_verify_mt_ws(const speck_pubkey_t *const PK,
+                       const char *const m,
+                       const uint64_t mlen,
+                       const speck_sign_t *const sig,
+                       uint32_t num_threads,
+                       speck_workspace_t *ws) {
+    speck_verify_ctx_t ctx;
+    SPECK_verify_init(&ctx);
+    SPECK_verify_update(&ctx, m, mlen);
+    verify_expand_pk(&ws->pk, PK);
+    return verify_from_prefix(PK, &ws->pk, &ctx.cmt_prefix, sig, ws, num_threads);
+} /* end SPECK_verify_mt_ws */
+
+/// starts the verification of a message provided in chunks
+/// \param ctx[out]: verification context
+void SPECK_verify_init(speck_verify_ctx_t *ctx) {
+    commit_prefix_init(&ctx->cmt_prefix);
+} /* end SPECK_verify_init */
+
+/// \param ctx[in/out]: verification context
+/// \param m[in]: next chunk of the message
+/// \param mlen[in]: length of the chunk in bytes
+void SPECK_verify_update(speck_verify_ctx_t *ctx,
+                         const char *const m,
+                         const uint64_t mlen) {
+    commit_prefix_update(&ctx->cmt_prefix, (const unsigned char *) m, mlen);
+} /* end SPECK_verify_update */
+
+/// NOTE: non-constant time
+/// verifies the signature of the message absorbed in ctx, which is left
+/// untouched
+/// \param PK[in]: public key
+/// \param ctx[in]: verification context
+/// \param sig[in]: signature
+/// \return 0: on failure
+///         1: on success
+int SPECK_verify_final(const speck_pubkey_t *const PK,
+                       const speck_verify_ctx_t *ctx,
+                       const speck_sign_t *const sig) {
+    PAR_CSPRNG_STATE_T cmt_prefix = ctx->cmt_prefix;
+    ALIGN(SPECK_WORKSPACE_ALIGN) unsigned char ws[WORKSPACE_VERIFY_BYTES];
+    expanded_pk_t *expanded = &((speck_workspace_t *) ws)->pk;
+    verify_expand_pk(expanded, PK);
+    return verify_from_prefix(PK, expanded, &cmt_prefix, sig, (speck_workspace_t *) ws, 1);
+} /* end SPECK_verify_final */
+
+/// same as SPECK_verify_final, employing the caller provided scratch memory
+/// instead of the stack
+/// \param ws[in/out]: workspace of at least SPECK_workspace_lowmem_bytes()
+///                    bytes, as the codewords are not employed
+int SPECK_verify_final_ws(const speck_pubkey_t *const PK,
+                          const speck_verify_ctx_t *ctx,
+                          const speck_sign_t *const sig,
+                          speck_workspace_t *ws) {
+    PAR_CSPRNG_STATE_T cmt_prefix = ctx->cmt_prefix;
+    verify_expand_pk(&ws->pk, PK);
+    return verify_from_prefix(PK, &ws->pk, &cmt_prefix, sig, ws, 1);
+} /* end SPECK_verify_final_ws */
+
+/// same as SPECK_verify, employing the caller provided scratch memory
+/// instead of the stack
+/// \param ws[in/out]: workspace, see SPECK_workspace_bytes
+int SPECK_verify_ws(const speck_pubkey_t *const PK,
+                    const char *const m,
+                    const uint64_t mlen,
+                    const speck_sign_t *const sig,
+                    speck_workspace_t *ws) {
+    return SPECK_verify_mt_ws(PK, m, mlen, sig, 1, ws);
+} /* end SPECK_verify_ws */
+
+/// unpacks the matrices of PK once, for the verification of several
+/// signatures with SPECK_verify_prepared
+/// \param PK[in]: public key, copied in prepared
+/// \param prepared[out]: prepared public key, see SPECK_prepared_pk_bytes
+void SPECK_prepare_pk(const speck_pubkey_t *const PK,
+                      speck_prepared_pk_t *prepared) {
+    memcpy(&prepared->PK, PK, sizeof(speck_pubkey_t));
+    verify_expand_pk(&prepared->expanded, &prepared->PK);
+} /* end SPECK_prepare_pk */
+
+/// same as SPECK_verify, with the public key prepared by SPECK_prepare_pk
+/// \param prepared[in]: prepared public key
+int SPECK_verify_prepared(const speck_prepared_pk_t *prepared,
+                          const char *const m,
+                          const uint64_t mlen,
+                          const speck_sign_t *const sig) {
+    speck_verify_ctx_t ctx;
+    SPECK_verify_init(&ctx);
+    SPECK_verify_update(&ctx, m, mlen);
+    /* neither the codewords, the digests of the rounds nor the unpacked
+     * matrices of the workspace are employed, the latter being taken from
+     * prepared */
+    ALIGN(SPECK_WORKSPACE_ALIGN) unsigned char ws[WORKSPACE_VERIFY_BYTES];
+    return verify_from_prefix(&prepared->PK, &prepared->expanded, &ctx.cmt_prefix, sig, (speck_workspace_t *) ws, 1);
+} /* end SPECK_verify_prepared */
+
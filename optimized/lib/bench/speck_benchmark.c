@@ -20,14 +20,22 @@
 #include <math.h>
 #include <stdio.h>
 #include <wchar.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
 
 #include "SPECK.h"
+#include "presign_pool.h"
 #include "codes.h"
 #include "transpose.h"
 #include "cycles.h"
 #include "rng.h"
 #include "csprng_hash.h"
 #include "permutation.h"
+#include "sort.h"
+#include "seedtree.h"
+#include "utils.h"
+#include "fips202.h"
 //#include "test_helpers.h"
 #include "api.h"
 
@@ -122,6 +130,480 @@ void microbench(void){
 
 }
 
+#define ROW_MAT_MULT_NUM_RUNS 1024
+
+/* cycles per vector of the product by a K x K matrix, one vector at a time
+ * and 4 at once, reducing every row and once per strip */
+void microbench_row_mat_mult(void){
+    welford_t timer, timer_x4, timer_lazy, timer_x4_lazy;
+    uint64_t cycles;
+
+    static FQ_ELEM M[K][K_pad];
+    FQ_ELEM vec[4][K_pad], out[4][K_pad], out_x4[4][K_pad];
+    FQ_ELEM *const out_ptr[4] = {out_x4[0], out_x4[1], out_x4[2], out_x4[3]};
+    const FQ_ELEM *const vec_ptr[4] = {vec[0], vec[1], vec[2], vec[3]};
+    for(uint32_t i = 0; i < K; i++) {
+        rand_range_q_elements(M[i], K);
+    }
+    for(uint32_t j = 0; j < 4; j++) {
+        rand_range_q_elements(vec[j], K);
+    }
+
+    welford_init(&timer);
+    welford_init(&timer_x4);
+    welford_init(&timer_lazy);
+    welford_init(&timer_x4_lazy);
+    int is_x4_ok = 1;
+    for(int i = 0; i <ROW_MAT_MULT_NUM_RUNS; i++) {
+        cycles = read_cycle_counter();
+        for(uint32_t j = 0; j < 4; j++) {
+            row_mat_mult_eager(out[j],vec[j],(const FQ_ELEM (*)[K_pad]) M,K,K);
+        }
+        welford_update(&timer,(read_cycle_counter()-cycles)/4.0);
+
+        cycles = read_cycle_counter();
+        row_mat_mult_x4_eager(out_ptr,NULL,vec_ptr,(const FQ_ELEM (*)[K_pad]) M,K,K);
+        welford_update(&timer_x4,(read_cycle_counter()-cycles)/4.0);
+        for(uint32_t j = 0; j < 4; j++) {
+            is_x4_ok &= memcmp(out[j], out_x4[j], K) == 0;
+        }
+
+        cycles = read_cycle_counter();
+        for(uint32_t j = 0; j < 4; j++) {
+            row_mat_mult_lazy(out_x4[j],vec[j],(const FQ_ELEM (*)[K_pad]) M,K,K);
+        }
+        welford_update(&timer_lazy,(read_cycle_counter()-cycles)/4.0);
+        for(uint32_t j = 0; j < 4; j++) {
+            is_x4_ok &= memcmp(out[j], out_x4[j], K) == 0;
+        }
+
+        cycles = read_cycle_counter();
+        row_mat_mult_x4_lazy(out_ptr,NULL,vec_ptr,(const FQ_ELEM (*)[K_pad]) M,K,K);
+        welford_update(&timer_x4_lazy,(read_cycle_counter()-cycles)/4.0);
+        for(uint32_t j = 0; j < 4; j++) {
+            is_x4_ok &= memcmp(out[j], out_x4[j], K) == 0;
+        }
+    }
+
+    /* the fused histogram counts c1 || c1*M as histogram_c1_c2 */
+    FQ_ELEM mset[4][Q], mset_fused[4][Q];
+    FQ_ELEM *const mset_ptr[4] = {mset_fused[0], mset_fused[1], mset_fused[2], mset_fused[3]};
+    for(uint32_t j = 0; j < 4; j++) {
+        histogram_c1_c2(mset[j],vec[j],out[j],K);
+        histogram(mset_fused[j],vec[j],K);
+    }
+    row_mat_mult_x4_histogram(out_ptr,mset_ptr,vec_ptr,(const FQ_ELEM (*)[K_pad]) M,K,K);
+    is_x4_ok &= memcmp(mset, mset_fused, sizeof(mset)) == 0;
+
+    printf("Row-matrix product cycles per vector (kernel,avg,stddev):\n");
+    printf("single,");
+    welford_print(timer);
+    printf("\nx4,");
+    welford_print(timer_x4);
+    printf("\nsingle lazy,");
+    welford_print(timer_lazy);
+    printf("\nx4 lazy,");
+    welford_print(timer_x4_lazy);
+    printf("\n");
+    fprintf(stderr,"Row-matrix product x4: %s", is_x4_ok ? "functional\n": "not functional\n" );
+}
+
+#define HISTOGRAM_NUM_RUNS 4096
+
+/* cycles per codeword of the histograms, with one table and with the
+ * interleaved sub-histograms, which are checked against each other */
+void microbench_histogram(void){
+    welford_t timer, timer_scalar, timer_c1_c2, timer_c1_c2_scalar;
+    uint64_t cycles;
+
+    FQ_ELEM codeword[N_pad];
+    FQ_ELEM mset[Q], mset_scalar[Q];
+    int is_histogram_ok = 1;
+
+    welford_init(&timer);
+    welford_init(&timer_scalar);
+    welford_init(&timer_c1_c2);
+    welford_init(&timer_c1_c2_scalar);
+    for(int i = 0; i <HISTOGRAM_NUM_RUNS; i++) {
+        rand_range_q_elements(codeword, N);
+
+        cycles = read_cycle_counter();
+        histogram_scalar(mset_scalar,codeword,N);
+        welford_update(&timer_scalar,read_cycle_counter()-cycles);
+
+        cycles = read_cycle_counter();
+        histogram(mset,codeword,N);
+        welford_update(&timer,read_cycle_counter()-cycles);
+        is_histogram_ok &= memcmp(mset, mset_scalar, Q) == 0;
+
+        cycles = read_cycle_counter();
+        histogram_c1_c2_scalar(mset_scalar,codeword,codeword+K,K);
+        welford_update(&timer_c1_c2_scalar,read_cycle_counter()-cycles);
+
+        cycles = read_cycle_counter();
+        histogram_c1_c2(mset,codeword,codeword+K,K);
+        welford_update(&timer_c1_c2,read_cycle_counter()-cycles);
+        is_histogram_ok &= memcmp(mset, mset_scalar, Q) == 0;
+    }
+    /* a single repeated element fills a bin up to N */
+    memset(codeword, Q-1, N);
+    histogram_scalar(mset_scalar,codeword,N);
+    histogram(mset,codeword,N);
+    is_histogram_ok &= memcmp(mset, mset_scalar, Q) == 0;
+
+    printf("Histogram cycles per codeword (kernel,avg,stddev):\n");
+    printf("scalar,");
+    welford_print(timer_scalar);
+    printf("\nsub-histograms,");
+    welford_print(timer);
+    printf("\nc1_c2 scalar,");
+    welford_print(timer_c1_c2_scalar);
+    printf("\nc1_c2 sub-histograms,");
+    welford_print(timer_c1_c2);
+    printf("\n");
+    fprintf(stderr,"Histogram: %s", is_histogram_ok ? "functional\n": "not functional\n" );
+}
+
+#define WORD_SAMPLE_NUM_RUNS 1024
+
+/* cycles per round of the sampling of u, one round at a time and 4 at once,
+ * which are checked against each other */
+void microbench_word_sample(void){
+    welford_t timer, timer_x4;
+    uint64_t cycles;
+
+    unsigned char seeds[4][SEED_LENGTH_BYTES], salt[HASH_DIGEST_LENGTH];
+    FQ_ELEM u[4][K], u_x4[4][K];
+    FQ_ELEM *const u_ptr[4] = {u_x4[0], u_x4[1], u_x4[2], u_x4[3]};
+    const unsigned char *const seed_ptr[4] = {seeds[0], seeds[1], seeds[2], seeds[3]};
+    int is_x4_ok = 1;
+
+    welford_init(&timer);
+    welford_init(&timer_x4);
+    for(int i = 0; i <WORD_SAMPLE_NUM_RUNS; i++) {
+        randombytes((unsigned char *) seeds, sizeof(seeds));
+        randombytes(salt, sizeof(salt));
+        const uint16_t round_index[4] = {4*i, 4*i+1, 4*i+2, 4*i+3};
+
+        cycles = read_cycle_counter();
+        for(uint32_t j = 0; j < 4; j++) {
+            word_sample_salt(u[j],seeds[j],salt,round_index[j]);
+        }
+        welford_update(&timer,(read_cycle_counter()-cycles)/4.0);
+
+        cycles = read_cycle_counter();
+        word_sample_salt_x4(u_ptr,seed_ptr,salt,round_index);
+        welford_update(&timer_x4,(read_cycle_counter()-cycles)/4.0);
+        is_x4_ok &= memcmp(u, u_x4, sizeof(u)) == 0;
+    }
+
+    printf("Word sampling cycles per round (sampler,avg,stddev):\n");
+    printf("single,");
+    welford_print(timer);
+    printf("\nx4,");
+    welford_print(timer_x4);
+    printf("\n");
+    fprintf(stderr,"Word sampling x4: %s", is_x4_ok ? "functional\n": "not functional\n" );
+}
+
+/* samples a word and a permutation from the same seed as the ephemeral
+ * permutations do, squeezing 8 bytes at a time from the state, and through
+ * the buffered reader; the words alone are timed too, as are the ranges of
+ * antiorthogonal_sample */
+void microbench_csprng_reader(void){
+    welford_t timer, timer_reader, timer_word, timer_word_reader;
+    uint64_t cycles;
+
+    unsigned char seed[SEED_LENGTH_BYTES];
+    FQ_ELEM u[K], u_reader[K];
+    permutation_t perm, perm_reader;
+    int is_reader_ok = 1;
+
+    welford_init(&timer);
+    welford_init(&timer_reader);
+    welford_init(&timer_word);
+    welford_init(&timer_word_reader);
+    for(int i = 0; i <WORD_SAMPLE_NUM_RUNS; i++) {
+        randombytes(seed, sizeof(seed));
+        SHAKE_STATE_STRUCT word_state;
+        csprng_reader_t word_reader;
+        initialize_csprng(&word_state, seed, SEED_LENGTH_BYTES);
+        csprng_reader_init(&word_reader, seed, SEED_LENGTH_BYTES);
+        for(uint32_t len = 1; len <= K; len += 25) {
+            rand_range_q_state_elements(&word_state, u, len);
+            rand_range_q_reader_elements(&word_reader, u_reader, len);
+            is_reader_ok &= memcmp(u, u_reader, len) == 0;
+        }
+
+        cycles = read_cycle_counter();
+        fq_star_rnd_state_elements(&word_state, u, K);
+        welford_update(&timer_word,read_cycle_counter()-cycles);
+
+        cycles = read_cycle_counter();
+        fq_star_rnd_reader_elements(&word_reader, u_reader, K);
+        welford_update(&timer_word_reader,read_cycle_counter()-cycles);
+        is_reader_ok &= memcmp(u, u_reader, sizeof(u)) == 0;
+
+        for(uint32_t j = 0; j < N; j++) {
+            perm.values[j] = j;
+            perm_reader.values[j] = j;
+        }
+
+        cycles = read_cycle_counter();
+        SHAKE_STATE_STRUCT state;
+        initialize_csprng(&state, seed, SEED_LENGTH_BYTES);
+        fq_star_rnd_state_elements(&state, u, K);
+        yt_shuffle_state(&state, perm.values);
+        welford_update(&timer,read_cycle_counter()-cycles);
+
+        cycles = read_cycle_counter();
+        csprng_reader_t reader;
+        csprng_reader_init(&reader, seed, SEED_LENGTH_BYTES);
+        fq_star_rnd_reader_elements(&reader, u_reader, K);
+        yt_shuffle_reader(&reader, perm_reader.values);
+        welford_update(&timer_reader,read_cycle_counter()-cycles);
+
+        is_reader_ok &= memcmp(u, u_reader, sizeof(u)) == 0;
+        is_reader_ok &= memcmp(&perm, &perm_reader, sizeof(perm)) == 0;
+    }
+
+    printf("Word sampling cycles (source,avg,stddev):\n");
+    printf("state,");
+    welford_print(timer_word);
+    printf("\nreader,");
+    welford_print(timer_word_reader);
+    printf("\n");
+    printf("Word and permutation sampling cycles (source,avg,stddev):\n");
+    printf("state,");
+    welford_print(timer);
+    printf("\nreader,");
+    welford_print(timer_reader);
+    printf("\n");
+    fprintf(stderr,"CSPRNG reader: %s", is_reader_ok ? "functional\n": "not functional\n" );
+}
+
+#define SEED_TREE_NUM_RUNS 64
+
+/* builds the seed tree one node at a time, and four nodes at a time, and
+ * walks its leaves depth-first; the path of a random challenge is expanded
+ * from the root too */
+void microbench_seed_tree(void){
+    welford_t timer, timer_x4, timer_walk;
+    uint64_t cycles;
+
+    static unsigned char seed_tree[NUM_NODES_SEED_TREE*SEED_LENGTH_BYTES];
+    static unsigned char seed_tree_x4[NUM_NODES_SEED_TREE*SEED_LENGTH_BYTES];
+    static unsigned char rounds_seeds[T*SEED_LENGTH_BYTES];
+    static unsigned char walk_seeds[T*SEED_LENGTH_BYTES];
+    unsigned char root_seed[SEED_LENGTH_BYTES], salt[HASH_DIGEST_LENGTH];
+    unsigned char indices_to_publish[T];
+    unsigned char seed_storage[SEED_TREE_MAX_PUBLISHED_BYTES];
+    unsigned char seed_storage_walk[SEED_TREE_MAX_PUBLISHED_BYTES];
+    unsigned char unpublished_leaves[W][SEED_LENGTH_BYTES];
+    int is_x4_ok = 1, is_walk_ok = 1;
+
+    welford_init(&timer);
+    welford_init(&timer_x4);
+    welford_init(&timer_walk);
+    for(int i = 0; i <SEED_TREE_NUM_RUNS; i++) {
+        randombytes(root_seed, sizeof(root_seed));
+        randombytes(salt, sizeof(salt));
+
+        cycles = read_cycle_counter();
+        BuildGGM_scalar(seed_tree,root_seed,salt);
+        welford_update(&timer,(read_cycle_counter()-cycles)/1000.0);
+
+        cycles = read_cycle_counter();
+        BuildGGM(seed_tree_x4,root_seed,salt);
+        welford_update(&timer_x4,(read_cycle_counter()-cycles)/1000.0);
+        is_x4_ok &= memcmp(seed_tree, seed_tree_x4, sizeof(seed_tree)) == 0;
+
+        cycles = read_cycle_counter();
+        ggm_walk_t leaves;
+        GGMLeavesInit(&leaves, root_seed, salt);
+        for(uint32_t j = 0; j < T; j += 4) {
+            GGMLeavesNext(&leaves, (unsigned char (*)[SEED_LENGTH_BYTES]) (walk_seeds + j*SEED_LENGTH_BYTES));
+        }
+        welford_update(&timer_walk,(read_cycle_counter()-cycles)/1000.0);
+        seed_leaves(rounds_seeds, seed_tree);
+        is_walk_ok &= memcmp(rounds_seeds, walk_seeds, sizeof(rounds_seeds)) == 0;
+
+        uint8_t fixed_weight_string[T];
+        SampleChallenge(fixed_weight_string, salt);
+        uint32_t num_unpublished = 0;
+        for(uint32_t j = 0; j < T; j++) {
+            indices_to_publish[j] = !!fixed_weight_string[j];
+        }
+        const uint32_t num_published = GGMPath(seed_tree, indices_to_publish, seed_storage);
+        is_walk_ok &= GGMPathFromRoot(root_seed, salt, indices_to_publish, seed_storage_walk,
+                                      (unsigned char *) unpublished_leaves) == num_published;
+        is_walk_ok &= memcmp(seed_storage, seed_storage_walk, num_published*SEED_LENGTH_BYTES) == 0;
+        for(uint32_t j = 0; j < T; j++) {
+            if (indices_to_publish[j]) {
+                is_walk_ok &= memcmp(unpublished_leaves[num_unpublished],
+                                     rounds_seeds + j*SEED_LENGTH_BYTES, SEED_LENGTH_BYTES) == 0;
+                num_unpublished++;
+            }
+        }
+    }
+
+    printf("Seed tree construction kcycles (expansion,avg,stddev):\n");
+    printf("single,");
+    welford_print(timer);
+    printf("\nx4,");
+    welford_print(timer_x4);
+    printf("\nwalk,");
+    welford_print(timer_walk);
+    printf("\n");
+    fprintf(stderr,"Seed tree x4: %s", is_x4_ok ? "functional\n": "not functional\n" );
+    fprintf(stderr,"Seed tree walk: %s", is_walk_ok ? "functional\n": "not functional\n" );
+}
+
+#define KECCAK_X4_NUM_RUNS 1024
+/* odd length, as the one of a commitment */
+#define KECCAK_X4_TIMED_LEN (HASH_DIGEST_LENGTH+Q+3)
+#define KECCAK_X4_MAX_LEN (3*SHAKE128_RATE+5)
+/* m||salt prefix of the timed commitments, for a 3 byte message */
+#define KECCAK_X4_PREFIX_LEN (HASH_DIGEST_LENGTH+3)
+
+/* absorbs and squeezes 4 inputs at once, split in three calls each, against
+ * 4 scalar SHAKE; every length up to three rates is checked, both rates, and
+ * so is the absorption of the last two parts fused with the padding. An odd
+ * length message is timed, as is a commitment from its prefix state */
+void microbench_keccak_x4(void){
+    welford_t timer, timer_x4, timer_cmt, timer_cmt_fused;
+    uint64_t cycles;
+
+    static unsigned char in[4][KECCAK_X4_MAX_LEN];
+    static unsigned char out[4][KECCAK_X4_MAX_LEN], out_x4[4][KECCAK_X4_MAX_LEN];
+    int is_x4_ok = 1;
+
+    randombytes((unsigned char *) in, sizeof(in));
+    for(uint32_t rate = SHAKE256_RATE; rate <= SHAKE128_RATE; rate += SHAKE128_RATE-SHAKE256_RATE) {
+        for(uint32_t len = 0; len <= KECCAK_X4_MAX_LEN; len++) {
+            /* uneven splits, crossing the lanes and the rate */
+            const uint32_t end[3] = {len/3, len/3 + (len - len/3 + 1)/2, len};
+            for(uint32_t j = 0; j < 4; j++) {
+                if (rate == SHAKE128_RATE) {
+                    shake128(out[j], len, in[j], len);
+                } else {
+                    shake256(out[j], len, in[j], len);
+                }
+            }
+            par_keccak_context ctx;
+            keccak_x4_init_rate(&ctx, rate);
+            for(uint32_t s = 0, from = 0; s < 3; from = end[s++]) {
+                keccak_x4_absorb(&ctx, in[0]+from, in[1]+from, in[2]+from, in[3]+from, end[s]-from);
+            }
+            keccak_x4_finalize(&ctx);
+            for(uint32_t s = 0, from = 0; s < 3; from = end[s++]) {
+                keccak_x4_squeeze(&ctx, out_x4[0]+from, out_x4[1]+from, out_x4[2]+from, out_x4[3]+from, end[s]-from);
+            }
+            for(uint32_t j = 0; j < 4; j++) {
+                is_x4_ok &= memcmp(out[j], out_x4[j], len) == 0;
+            }
+
+            const unsigned char *const mid[4] = {in[0]+end[0], in[1]+end[0], in[2]+end[0], in[3]+end[0]};
+            const unsigned char *const tail[4] = {in[0]+end[1], in[1]+end[1], in[2]+end[1], in[3]+end[1]};
+            keccak_x4_init_rate(&ctx, rate);
+            keccak_x4_absorb(&ctx, in[0], in[1], in[2], in[3], end[0]);
+            keccak_x4_absorb_final(&ctx, mid, end[1]-end[0], tail, len-end[1]);
+            keccak_x4_squeeze(&ctx, out_x4[0], out_x4[1], out_x4[2], out_x4[3], len);
+            for(uint32_t j = 0; j < 4; j++) {
+                is_x4_ok &= memcmp(out[j], out_x4[j], len) == 0;
+            }
+        }
+    }
+
+    welford_init(&timer);
+    welford_init(&timer_x4);
+    for(int i = 0; i <KECCAK_X4_NUM_RUNS; i++) {
+        cycles = read_cycle_counter();
+        for(uint32_t j = 0; j < 4; j++) {
+            shake256(out[j], HASH_DIGEST_LENGTH, in[j], KECCAK_X4_TIMED_LEN);
+        }
+        welford_update(&timer,(read_cycle_counter()-cycles)/4.0);
+
+        cycles = read_cycle_counter();
+        par_keccak_context ctx;
+        keccak_x4_init_rate(&ctx, SHAKE256_RATE);
+        keccak_x4_absorb(&ctx, in[0], in[1], in[2], in[3], KECCAK_X4_TIMED_LEN);
+        keccak_x4_finalize(&ctx);
+        keccak_x4_squeeze(&ctx, out_x4[0], out_x4[1], out_x4[2], out_x4[3], HASH_DIGEST_LENGTH);
+        welford_update(&timer_x4,(read_cycle_counter()-cycles)/4.0);
+    }
+
+    par_keccak_context prefix;
+    const unsigned char *const histograms[4] = {in[0], in[1], in[2], in[3]};
+    const unsigned char *const dscs[4] = {in[0]+Q, in[1]+Q, in[2]+Q, in[3]+Q};
+    xof_shake_x4_init(&prefix);
+    xof_shake_x4_update(&prefix, in[0], in[0], in[0], in[0], KECCAK_X4_PREFIX_LEN);
+    welford_init(&timer_cmt);
+    welford_init(&timer_cmt_fused);
+    for(int i = 0; i <KECCAK_X4_NUM_RUNS; i++) {
+        par_keccak_context ctx;
+        cycles = read_cycle_counter();
+        ctx = prefix;
+        xof_shake_x4_update(&ctx, histograms[0], histograms[1], histograms[2], histograms[3], Q);
+        xof_shake_x4_update(&ctx, dscs[0], dscs[1], dscs[2], dscs[3], 2);
+        xof_shake_x4_final(&ctx);
+        xof_shake_x4_extract(&ctx, out[0], out[1], out[2], out[3], HASH_DIGEST_LENGTH);
+        welford_update(&timer_cmt,(read_cycle_counter()-cycles)/4.0);
+
+        cycles = read_cycle_counter();
+        ctx = prefix;
+        xof_shake_x4_update_final(&ctx, histograms, Q, dscs, 2);
+        xof_shake_x4_extract(&ctx, out_x4[0], out_x4[1], out_x4[2], out_x4[3], HASH_DIGEST_LENGTH);
+        welford_update(&timer_cmt_fused,(read_cycle_counter()-cycles)/4.0);
+        for(uint32_t j = 0; j < 4; j++) {
+            is_x4_ok &= memcmp(out[j], out_x4[j], HASH_DIGEST_LENGTH) == 0;
+        }
+    }
+
+    printf("SHAKE256 cycles per %d byte input (hash,avg,stddev):\n", KECCAK_X4_TIMED_LEN);
+    printf("single,");
+    welford_print(timer);
+    printf("\nx4,");
+    welford_print(timer_x4);
+    printf("\n");
+    printf("Commitment cycles from the prefix state (absorption,avg,stddev):\n");
+    printf("separate,");
+    welford_print(timer_cmt);
+    printf("\nfused,");
+    welford_print(timer_cmt_fused);
+    printf("\n");
+    fprintf(stderr,"Keccak x4 absorb and squeeze: %s", is_x4_ok ? "functional\n": "not functional\n" );
+}
+
+/* compares the lazy reduction kernels against the eager ones on every pair
+ * (matrix coefficient, vector coefficient), each summed over all the K rows,
+ * i.e., the largest sum it can appear in */
+void test_row_mat_mult_lazy(void){
+    static FQ_ELEM M[K][K_pad];
+    FQ_ELEM vec[K_pad], out[K_pad], out_lazy[K_pad];
+    int is_lazy_ok = 1;
+
+    for(uint32_t a = 0; a < Q; a++) {
+        for(uint32_t i = 0; i < K; i++) {
+            for(uint32_t col = 0; col < K_pad; col++) {
+                M[i][col] = (a + col) % Q;
+            }
+        }
+        for(uint32_t b = 0; b < Q; b++) {
+            memset(vec, b, sizeof(vec));
+
+            row_mat_mult_eager(out,vec,(const FQ_ELEM (*)[K_pad]) M,K,K);
+            row_mat_mult_lazy(out_lazy,vec,(const FQ_ELEM (*)[K_pad]) M,K,K);
+            is_lazy_ok &= memcmp(out, out_lazy, K_pad) == 0;
+
+            row_mat_mult_opp_tran_eager(out,vec,(const FQ_ELEM (*)[K_pad]) M,K,K,0);
+            row_mat_mult_opp_tran_lazy(out_lazy,vec,(const FQ_ELEM (*)[K_pad]) M,K,K,0);
+            is_lazy_ok &= memcmp(out, out_lazy, K_pad) == 0;
+        }
+    }
+    fprintf(stderr,"Row-matrix product lazy reduction: %s", is_lazy_ok ? "functional\n": "not functional\n" );
+}
+
 void info(void){
     fprintf(stderr,"Code parameters: n= %d, k= %d, q=%d\n", N,K,Q);
     fprintf(stderr,"num. keypairs = %d\n",NUM_KEYPAIRS);
@@ -131,6 +613,11 @@ void info(void){
     fprintf(stderr,"Signature: %luB, %f\n", sizeof(speck_sign_t), ((float) sizeof(speck_sign_t))/1024);
 }
 
+/* keypair generated by SPECK_sign_verify_speed, reused by the benchmarks
+ * following it */
+static unsigned char pk[CRYPTO_PUBLICKEYBYTES];
+static unsigned char sk[CRYPTO_SECRETKEYBYTES];
+
 void SPECK_sign_verify_speed(void){
     fprintf(stderr,"Computing number of clock cycles as the average of %d runs\n", NUM_RUNS);
     welford_t timer;
@@ -141,8 +628,6 @@ void SPECK_sign_verify_speed(void){
     uint64_t ms_sum;
     unsigned long long siglens = 0; 
 
-    unsigned char pk[CRYPTO_PUBLICKEYBYTES];
-    unsigned char sk[CRYPTO_SECRETKEYBYTES];
     unsigned char m[8] = "Signme!";
     unsigned long long mlen = 8;
     unsigned long long smlen;
@@ -212,12 +697,467 @@ void SPECK_sign_verify_speed(void){
     fprintf(stderr,"Keygen-Sign-Verify: %s", is_signature_ok == 0 ? "functional\n": "not functional\n" );
 }
 
+#define MAX_BENCH_THREADS 8
+
+void SPECK_sign_mt_speed(void){
+    welford_t timer;
+    uint64_t cycles;
+
+    const speck_prikey_t *SK = (const speck_prikey_t *) sk;
+    const speck_pubkey_t *PK = (const speck_pubkey_t *) pk;
+    speck_sign_t sig, sig_mt;
+    const char m[8] = "Signme!";
+
+    /* the same platform CSPRNG state yields the same salt and seed tree */
+    SHAKE_STATE_STRUCT csprng_state_backup = platform_csprng_state;
+    SPECK_sign(SK, PK, m, sizeof(m), &sig);
+
+    int is_sig_identical = 1;
+    printf("Multi-threaded signing kCycles (threads,avg,stddev):\n");
+    for(uint32_t num_threads = 1; num_threads <= MAX_BENCH_THREADS; num_threads *= 2) {
+        platform_csprng_state = csprng_state_backup;
+        SPECK_sign_mt(SK, PK, m, sizeof(m), &sig_mt, num_threads);
+        is_sig_identical &= (memcmp(&sig, &sig_mt, sizeof(speck_sign_t)) == 0);
+
+        welford_init(&timer);
+        for(int i = 0; i <NUM_RUNS; i++) {
+            cycles = read_cycle_counter();
+            SPECK_sign_mt(SK, PK, m, sizeof(m), &sig_mt, num_threads);
+            welford_update(&timer,(read_cycle_counter()-cycles)/1000.0);
+        }
+        printf("%u,", num_threads);
+        welford_print(timer);
+        printf("\n");
+    }
+    fprintf(stderr,"Multi-threaded Sign: %s", is_sig_identical ? "bit-identical\n": "not bit-identical\n" );
+}
+
+void SPECK_verify_mt_speed(void){
+    welford_t timer;
+    uint64_t cycles;
+
+    const speck_prikey_t *SK = (const speck_prikey_t *) sk;
+    const speck_pubkey_t *PK = (const speck_pubkey_t *) pk;
+    speck_sign_t sig;
+    const char m[8] = "Signme!";
+    const char m_forged[8] = "Forged!";
+
+    SPECK_sign(SK, PK, m, sizeof(m), &sig);
+
+    int is_result_identical = 1;
+    printf("Multi-threaded verification kCycles (threads,avg,stddev):\n");
+    for(uint32_t num_threads = 1; num_threads <= MAX_BENCH_THREADS; num_threads *= 2) {
+        is_result_identical &= (SPECK_verify_mt(PK, m, sizeof(m), &sig, num_threads) == 1);
+        is_result_identical &= (SPECK_verify_mt(PK, m_forged, sizeof(m_forged), &sig, num_threads) == 0);
+
+        welford_init(&timer);
+        for(int i = 0; i <NUM_RUNS; i++) {
+            cycles = read_cycle_counter();
+            SPECK_verify_mt(PK, m, sizeof(m), &sig, num_threads);
+            welford_update(&timer,(read_cycle_counter()-cycles)/1000.0);
+        }
+        printf("%u,", num_threads);
+        welford_print(timer);
+        printf("\n");
+    }
+    fprintf(stderr,"Multi-threaded Verify: %s", is_result_identical ? "functional\n": "not functional\n" );
+}
+
+/* the streaming benchmark feeds messages of up to 2^STREAM_MAX_LOG_BYTES
+ * bytes in chunks of STREAM_CHUNK_BYTES, never holding them in memory */
+#define STREAM_CHUNK_BYTES 4096
+#define STREAM_MAX_LOG_BYTES 20
+#define STREAM_NUM_RUNS 8
+
+void SPECK_stream_speed(void){
+    welford_t sign_timer, verify_timer;
+    uint64_t cycles;
+
+    const speck_prikey_t *SK = (const speck_prikey_t *) sk;
+    const speck_pubkey_t *PK = (const speck_pubkey_t *) pk;
+    speck_sign_t sig, sig_stream;
+    speck_sign_ctx_t sign_ctx;
+    speck_verify_ctx_t verify_ctx;
+
+    static char m[3*STREAM_CHUNK_BYTES+5];
+    for(size_t i = 0; i < sizeof(m); i++) {
+        m[i] = (char) (i*31+7);
+    }
+
+    /* uneven chunks must yield the same signature as the whole message */
+    SHAKE_STATE_STRUCT csprng_state_backup = platform_csprng_state;
+    SPECK_sign(SK, PK, m, sizeof(m), &sig);
+    platform_csprng_state = csprng_state_backup;
+    SPECK_sign_init(&sign_ctx);
+    SPECK_sign_update(&sign_ctx, m, 1);
+    SPECK_sign_update(&sign_ctx, m+1, STREAM_CHUNK_BYTES);
+    SPECK_sign_update(&sign_ctx, m+1+STREAM_CHUNK_BYTES, sizeof(m)-1-STREAM_CHUNK_BYTES);
+    SPECK_sign_final(SK, PK, &sign_ctx, &sig_stream);
+
+    SPECK_verify_init(&verify_ctx);
+    SPECK_verify_update(&verify_ctx, m, sizeof(m)-1);
+    int is_forged_ok = SPECK_verify_final(PK, &verify_ctx, &sig_stream);
+    SPECK_verify_update(&verify_ctx, m+sizeof(m)-1, 1);
+    int is_stream_ok = (memcmp(&sig, &sig_stream, sizeof(speck_sign_t)) == 0) &&
+                       SPECK_verify_final(PK, &verify_ctx, &sig_stream) == 1 &&
+                       is_forged_ok == 0;
+
+    printf("Streaming kCycles (message bytes,sign avg,sign stddev,verify avg,verify stddev):\n");
+    for(int log_len = 10; log_len <= STREAM_MAX_LOG_BYTES; log_len += 2) {
+        const uint64_t mlen = (uint64_t)1 << log_len;
+        welford_init(&sign_timer);
+        welford_init(&verify_timer);
+        for(int i = 0; i <STREAM_NUM_RUNS; i++) {
+            cycles = read_cycle_counter();
+            SPECK_sign_init(&sign_ctx);
+            for(uint64_t j = 0; j < mlen; j += STREAM_CHUNK_BYTES) {
+                SPECK_sign_update(&sign_ctx, m, mlen-j < STREAM_CHUNK_BYTES ? mlen-j : STREAM_CHUNK_BYTES);
+            }
+            SPECK_sign_final(SK, PK, &sign_ctx, &sig_stream);
+            welford_update(&sign_timer,(read_cycle_counter()-cycles)/1000.0);
+
+            cycles = read_cycle_counter();
+            SPECK_verify_init(&verify_ctx);
+            for(uint64_t j = 0; j < mlen; j += STREAM_CHUNK_BYTES) {
+                SPECK_verify_update(&verify_ctx, m, mlen-j < STREAM_CHUNK_BYTES ? mlen-j : STREAM_CHUNK_BYTES);
+            }
+            is_stream_ok &= SPECK_verify_final(PK, &verify_ctx, &sig_stream) == 1;
+            welford_update(&verify_timer,(read_cycle_counter()-cycles)/1000.0);
+        }
+        printf("%lu,", (unsigned long) mlen);
+        welford_print(sign_timer);
+        printf(",");
+        welford_print(verify_timer);
+        printf("\n");
+    }
+    fprintf(stderr,"Streaming Sign-Verify: %s", is_stream_ok ? "functional\n": "not functional\n" );
+}
+
+/* the workspace and bundle variants are run on a thread with a stack much
+ * smaller than the memory needed by the signature */
+#define WORKSPACE_THREAD_STACK_BYTES (256*1024)
+#define WORKSPACE_NUM_RUNS 16
+
+typedef struct {
+    SHAKE_STATE_STRUCT csprng_state;
+    speck_workspace_t *ws;
+    speck_workspace_t *lowmem_ws;
+    speck_bundle_t *bundle;
+    speck_sign_t sig;
+    speck_sign_t lowmem_sig;
+    speck_sign_t mt_sig;
+    speck_sign_t final_sig;
+    speck_sign_t bundle_sig;
+    int is_verify_ok;
+} workspace_test_t;
+
+static
+void *SPECK_workspace_sign_verify(void *arg){
+    workspace_test_t *test = (workspace_test_t *) arg;
+    const speck_prikey_t *SK = (const speck_prikey_t *) sk;
+    const speck_pubkey_t *PK = (const speck_pubkey_t *) pk;
+    const char m[8] = "Signme!";
+
+    platform_csprng_state = test->csprng_state;
+    SPECK_sign_ws(SK, PK, m, sizeof(m), &test->sig, test->ws);
+    test->is_verify_ok = SPECK_verify_ws(PK, m, sizeof(m), &test->sig, test->lowmem_ws);
+    platform_csprng_state = test->csprng_state;
+    SPECK_sign_lowmem_ws(SK, PK, m, sizeof(m), &test->lowmem_sig, test->lowmem_ws);
+
+    platform_csprng_state = test->csprng_state;
+    SPECK_sign_mt_ws(SK, PK, m, sizeof(m), &test->mt_sig, 2, test->ws);
+    test->is_verify_ok &= SPECK_verify_mt_ws(PK, m, sizeof(m), &test->mt_sig, 2, test->lowmem_ws);
+
+    speck_sign_ctx_t sign_ctx;
+    SPECK_sign_init(&sign_ctx);
+    SPECK_sign_update(&sign_ctx, m, 3);
+    SPECK_sign_update(&sign_ctx, m + 3, sizeof(m) - 3);
+    platform_csprng_state = test->csprng_state;
+    SPECK_sign_final_ws(SK, PK, &sign_ctx, &test->final_sig, test->ws);
+    speck_verify_ctx_t verify_ctx;
+    SPECK_verify_init(&verify_ctx);
+    SPECK_verify_update(&verify_ctx, m, sizeof(m));
+    test->is_verify_ok &= SPECK_verify_final_ws(PK, &verify_ctx, &test->final_sig, test->lowmem_ws);
+
+    platform_csprng_state = test->csprng_state;
+    SPECK_bundle_precompute(SK, PK, test->bundle);
+    SPECK_sign_with_bundle(SK, m, sizeof(m), &test->bundle_sig, test->bundle);
+    return NULL;
+}
+
+/* allocates bytes aligned to SPECK_WORKSPACE_ALIGN in *aligned, returns
+ * the pointer to be freed */
+static
+unsigned char *workspace_alloc(void **aligned, size_t bytes){
+    unsigned char *mem = malloc(bytes + SPECK_WORKSPACE_ALIGN);
+    *aligned = (void *) NEXT_MULTIPLE((uintptr_t) mem, SPECK_WORKSPACE_ALIGN);
+    return mem;
+}
+
+void SPECK_workspace_speed(void){
+    welford_t timer;
+    uint64_t cycles;
+
+    const speck_prikey_t *SK = (const speck_prikey_t *) sk;
+    const speck_pubkey_t *PK = (const speck_pubkey_t *) pk;
+    speck_sign_t sig;
+    const char m[8] = "Signme!";
+    workspace_test_t test;
+
+    unsigned char *ws_mem = workspace_alloc((void **) &test.ws, SPECK_workspace_bytes());
+    unsigned char *lowmem_ws_mem = workspace_alloc((void **) &test.lowmem_ws, SPECK_workspace_lowmem_bytes());
+    unsigned char *bundle_mem = workspace_alloc((void **) &test.bundle, SPECK_bundle_bytes());
+
+    test.csprng_state = platform_csprng_state;
+    SPECK_sign(SK, PK, m, sizeof(m), &sig);
+
+    pthread_attr_t attr;
+    pthread_t thread;
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, WORKSPACE_THREAD_STACK_BYTES);
+    int is_ws_ok = ws_mem != NULL && lowmem_ws_mem != NULL && bundle_mem != NULL &&
+                   pthread_create(&thread, &attr, SPECK_workspace_sign_verify, &test) == 0;
+    if (is_ws_ok) {
+        pthread_join(thread, NULL);
+        is_ws_ok = test.is_verify_ok == 1 &&
+                   memcmp(&sig, &test.sig, sizeof(speck_sign_t)) == 0 &&
+                   memcmp(&sig, &test.lowmem_sig, sizeof(speck_sign_t)) == 0 &&
+                   memcmp(&sig, &test.mt_sig, sizeof(speck_sign_t)) == 0 &&
+                   memcmp(&sig, &test.final_sig, sizeof(speck_sign_t)) == 0 &&
+                   memcmp(&sig, &test.bundle_sig, sizeof(speck_sign_t)) == 0;
+    }
+    pthread_attr_destroy(&attr);
+
+    if (is_ws_ok) {
+        printf("Signing workspace (mode,bytes,kCycles avg,stddev):\n");
+        welford_init(&timer);
+        for(int i = 0; i <WORKSPACE_NUM_RUNS; i++) {
+            cycles = read_cycle_counter();
+            SPECK_sign_ws(SK, PK, m, sizeof(m), &sig, test.ws);
+            welford_update(&timer,(read_cycle_counter()-cycles)/1000.0);
+        }
+        printf("full,%lu,", (unsigned long) SPECK_workspace_bytes());
+        welford_print(timer);
+        printf("\n");
+
+        welford_init(&timer);
+        for(int i = 0; i <WORKSPACE_NUM_RUNS; i++) {
+            cycles = read_cycle_counter();
+            SPECK_sign_lowmem_ws(SK, PK, m, sizeof(m), &sig, test.lowmem_ws);
+            welford_update(&timer,(read_cycle_counter()-cycles)/1000.0);
+        }
+        printf("lowmem,%lu,", (unsigned long) SPECK_workspace_lowmem_bytes());
+        welford_print(timer);
+        printf("\n");
+    }
+    free(ws_mem);
+    free(lowmem_ws_mem);
+    free(bundle_mem);
+    fprintf(stderr,"Workspace Sign-Verify: %s", is_ws_ok ? "functional\n": "not functional\n" );
+}
+
+void SPECK_prepared_verify_speed(void){
+    welford_t prepare_timer, verify_timer, prepared_timer;
+    uint64_t cycles;
+
+    const speck_prikey_t *SK = (const speck_prikey_t *) sk;
+    const speck_pubkey_t *PK = (const speck_pubkey_t *) pk;
+    speck_sign_t sig;
+    char m[8] = "Signme!";
+    speck_prepared_pk_t *prepared;
+
+    unsigned char *prepared_mem = workspace_alloc((void **) &prepared, SPECK_prepared_pk_bytes());
+    if (prepared_mem == NULL) {
+        fprintf(stderr,"Prepared Verify: not functional\n");
+        return;
+    }
+    SPECK_sign(SK, PK, m, sizeof(m), &sig);
+
+    welford_init(&prepare_timer);
+    for(int i = 0; i <WORKSPACE_NUM_RUNS; i++) {
+        cycles = read_cycle_counter();
+        SPECK_prepare_pk(PK, prepared);
+        welford_update(&prepare_timer,(read_cycle_counter()-cycles)/1000.0);
+    }
+
+    int is_prepared_ok = 1;
+    welford_init(&verify_timer);
+    welford_init(&prepared_timer);
+    for(int i = 0; i <WORKSPACE_NUM_RUNS; i++) {
+        cycles = read_cycle_counter();
+        int is_verify_ok = SPECK_verify(PK, m, sizeof(m), &sig);
+        welford_update(&verify_timer,(read_cycle_counter()-cycles)/1000.0);
+
+        cycles = read_cycle_counter();
+        int is_prepared_verify_ok = SPECK_verify_prepared(prepared, m, sizeof(m), &sig);
+        welford_update(&prepared_timer,(read_cycle_counter()-cycles)/1000.0);
+        is_prepared_ok &= is_verify_ok == 1 && is_prepared_verify_ok == 1;
+    }
+    m[0] ^= 1;
+    is_prepared_ok &= SPECK_verify_prepared(prepared, m, sizeof(m), &sig) == 0;
+
+    printf("Prepared public key (step,kCycles avg,stddev):\n");
+    printf("prepare,");
+    welford_print(prepare_timer);
+    printf("\nverify,");
+    welford_print(verify_timer);
+    printf("\nverify prepared,");
+    welford_print(prepared_timer);
+    printf("\n");
+    free(prepared_mem);
+    fprintf(stderr,"Prepared Verify: %s", is_prepared_ok ? "functional\n": "not functional\n" );
+}
+
+void SPECK_bundle_speed(void){
+    welford_t offline_timer, online_timer;
+    uint64_t cycles;
+
+    const speck_prikey_t *SK = (const speck_prikey_t *) sk;
+    const speck_pubkey_t *PK = (const speck_pubkey_t *) pk;
+    speck_sign_t sig, sig_bundle;
+    const char m[8] = "Signme!";
+
+    speck_bundle_t *bundle;
+    unsigned char *bundle_mem = workspace_alloc((void **) &bundle, SPECK_bundle_bytes());
+    if (bundle_mem == NULL) {
+        fprintf(stderr,"Offline-Online Sign: not functional\n");
+        return;
+    }
+
+    /* the bundle draws the same salt and seed tree as SPECK_sign */
+    SHAKE_STATE_STRUCT csprng_state_backup = platform_csprng_state;
+    SPECK_sign(SK, PK, m, sizeof(m), &sig);
+    platform_csprng_state = csprng_state_backup;
+    SPECK_bundle_precompute(SK, PK, bundle);
+    int is_bundle_ok = SPECK_sign_with_bundle(SK, m, sizeof(m), &sig_bundle, bundle) != 0 &&
+                       memcmp(&sig, &sig_bundle, sizeof(speck_sign_t)) == 0 &&
+                       SPECK_verify(PK, m, sizeof(m), &sig_bundle) == 1;
+    /* a bundle is single use */
+    is_bundle_ok &= SPECK_sign_with_bundle(SK, m, sizeof(m), &sig_bundle, bundle) == 0;
+
+    welford_init(&offline_timer);
+    welford_init(&online_timer);
+    for(int i = 0; i <WORKSPACE_NUM_RUNS; i++) {
+        cycles = read_cycle_counter();
+        SPECK_bundle_precompute(SK, PK, bundle);
+        welford_update(&offline_timer,(read_cycle_counter()-cycles)/1000.0);
+        cycles = read_cycle_counter();
+        SPECK_sign_with_bundle(SK, m, sizeof(m), &sig_bundle, bundle);
+        welford_update(&online_timer,(read_cycle_counter()-cycles)/1000.0);
+    }
+    printf("Offline bundle (%luB) kCycles (avg,stddev): ", (unsigned long) SPECK_bundle_bytes());
+    welford_print(offline_timer);
+    printf("\nOnline signing kCycles (avg,stddev): ");
+    welford_print(online_timer);
+    printf("\n");
+    free(bundle_mem);
+    fprintf(stderr,"Offline-Online Sign: %s", is_bundle_ok ? "functional\n": "not functional\n" );
+}
+
+#define POOL_CAPACITY 4
+
+void SPECK_presign_pool_speed(void){
+    welford_t timer;
+    uint64_t cycles;
+
+    const speck_prikey_t *SK = (const speck_prikey_t *) sk;
+    const speck_pubkey_t *PK = (const speck_pubkey_t *) pk;
+    speck_sign_t sig;
+    const char m[8] = "Signme!";
+    speck_presign_pool_stats_t stats;
+
+    speck_presign_pool_t *pool = SPECK_presign_pool_create(SK, PK, POOL_CAPACITY);
+    if (pool == NULL) {
+        fprintf(stderr,"Presign pool: not functional\n");
+        return;
+    }
+
+    /* waits for the background thread to fill the pool */
+    const struct timespec poll_interval = {0, 1000000};
+    do {
+        nanosleep(&poll_interval, NULL);
+        SPECK_presign_pool_stats(pool, &stats);
+    } while (stats.depth < POOL_CAPACITY);
+
+    /* a burst of twice the capacity, without giving time to refill */
+    int is_pool_ok = 1;
+    welford_init(&timer);
+    for(int i = 0; i < 2*POOL_CAPACITY; i++) {
+        cycles = read_cycle_counter();
+        is_pool_ok &= SPECK_presign_pool_sign(pool, m, sizeof(m), &sig) != 0;
+        welford_update(&timer,(read_cycle_counter()-cycles)/1000.0);
+        is_pool_ok &= SPECK_verify(PK, m, sizeof(m), &sig) == 1;
+    }
+    SPECK_presign_pool_stats(pool, &stats);
+    SPECK_presign_pool_destroy(pool);
+    is_pool_ok &= stats.hits + stats.misses == 2*POOL_CAPACITY && stats.hits >= POOL_CAPACITY;
+
+    printf("Presign pool burst kCycles (avg,stddev): ");
+    welford_print(timer);
+    printf("\nPresign pool (capacity,depth,hits,misses,refills,refill avg ms,refill max ms): %u,%u,%lu,%lu,%lu,%.2f,%.2f\n",
+           stats.capacity, stats.depth,
+           (unsigned long) stats.hits, (unsigned long) stats.misses, (unsigned long) stats.refills,
+           stats.refills ? stats.refill_ns_total/1e6/stats.refills : 0.0, stats.refill_ns_max/1e6);
+    fprintf(stderr,"Presign pool: %s", is_pool_ok ? "functional\n": "not functional\n" );
+}
+
+#define BATCH_SIZE 8
+
+/* the batch is a convenience wrapper signing at the pace of SPECK_sign, it
+ * is only checked against it */
+void SPECK_sign_batch_check(void){
+    const speck_prikey_t *SK = (const speck_prikey_t *) sk;
+    const speck_pubkey_t *PK = (const speck_pubkey_t *) pk;
+    static speck_sign_t sigs[BATCH_SIZE], sigs_batch[BATCH_SIZE];
+    char m[BATCH_SIZE][8];
+    const char *msgs[BATCH_SIZE];
+    uint64_t lens[BATCH_SIZE];
+    for(int i = 0; i < BATCH_SIZE; i++) {
+        snprintf(m[i], sizeof(m[i]), "Sign %d", i);
+        msgs[i] = m[i];
+        lens[i] = sizeof(m[i]);
+    }
+
+    speck_workspace_t *ws;
+    unsigned char *ws_mem = workspace_alloc((void **) &ws, SPECK_workspace_bytes());
+    int is_batch_ok = ws_mem != NULL;
+    if (is_batch_ok) {
+        SHAKE_STATE_STRUCT csprng_state_backup = platform_csprng_state;
+        for(int i = 0; i < BATCH_SIZE; i++) {
+            SPECK_sign(SK, PK, msgs[i], lens[i], &sigs[i]);
+        }
+        platform_csprng_state = csprng_state_backup;
+        SPECK_sign_batch_ws(SK, PK, msgs, lens, sigs_batch, BATCH_SIZE, ws);
+        is_batch_ok = memcmp(sigs, sigs_batch, sizeof(sigs)) == 0;
+    }
+    free(ws_mem);
+    fprintf(stderr,"Batch Sign: %s", is_batch_ok ? "bit-identical\n": "not bit-identical\n" );
+}
+
 int main(int argc, char* argv[]){
     (void)argc;
     (void)argv;
     setup_cycle_counter();
     initialize_csprng(&platform_csprng_state, (const unsigned char *)"0123456789012345",16);
     fprintf(stderr,"SPECK implementation benchmarking tool\n");
+    /* the kernel benchmarks leave the keypair sampled as without them */
+    SHAKE_STATE_STRUCT csprng_state_backup = platform_csprng_state;
+    test_row_mat_mult_lazy();
+    microbench_row_mat_mult();
+    microbench_histogram();
+    microbench_word_sample();
+    microbench_csprng_reader();
+    microbench_seed_tree();
+    microbench_keccak_x4();
+    platform_csprng_state = csprng_state_backup;
     SPECK_sign_verify_speed();
+    SPECK_sign_mt_speed();
+    SPECK_verify_mt_speed();
+    SPECK_stream_speed();
+    SPECK_workspace_speed();
+    SPECK_prepared_verify_speed();
+    SPECK_bundle_speed();
+    SPECK_presign_pool_speed();
+    SPECK_sign_batch_check();
     return 0;
 }
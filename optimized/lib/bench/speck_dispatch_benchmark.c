@@ -0,0 +1,121 @@
+/**
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ''AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **/
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "dispatch.h"
+#include "cycles.h"
+
+#define DISPATCH_NUM_RUNS 16
+
+typedef struct {
+    long double mean;
+    long double M2;
+    long count;
+} welford_t;
+
+static inline
+void welford_init(welford_t *state) {
+    state->mean = 0.0;
+    state->M2 = 0.0;
+    state->count = 0;
+    return;
+}
+
+static inline
+void welford_update(welford_t *state, long double sample) {
+    long double delta, delta2;
+    state->count = state->count + 1;
+    delta = sample - state->mean;
+    state->mean += delta / (long double)(state->count);
+    delta2 = sample - state->mean;
+    state->M2 += delta * delta2;
+}
+
+static inline
+void welford_print(const welford_t state) {
+    printf("%.2Lf,%.2Lf",
+           state.mean,
+           sqrtl(state.M2/(long double)(state.count-1)));
+}
+
+static speck_prikey_t sk[SPECK_NUM_BACKENDS];
+static speck_pubkey_t pk[SPECK_NUM_BACKENDS];
+static speck_sign_t sig[SPECK_NUM_BACKENDS];
+
+/* every backend samples the keypair and signs from the same seed: the
+ * backends are bit-identical, the keypairs and the signatures agree */
+int main(void) {
+    setup_cycle_counter();
+    fprintf(stderr,"SPECK runtime dispatch benchmarking tool\n");
+    const speck_backend_t backend = SPECK_backend();
+    printf("Selected backend: %s\n", SPECK_backend_name(backend));
+
+    const char message[8] = "Signme!";
+    int is_dispatch_ok = 1;
+    int reference = -1;
+    printf("Timings (kcycles) of the backends (backend,operation,avg,stddev):\n");
+    for (int b = 0; b < SPECK_NUM_BACKENDS; b++) {
+        const speck_backend_api_t *api = SPECK_backend_api(b);
+        if (api == NULL) {
+            printf("%s,unsupported\n", SPECK_backend_name(b));
+            continue;
+        }
+        api->initialize_csprng(api->csprng_state, (const unsigned char *)"0123456789012345",16);
+        api->keygen(&sk[b], &pk[b]);
+
+        welford_t timer_sign, timer_verify;
+        welford_init(&timer_sign);
+        welford_init(&timer_verify);
+        for (int i = 0; i < DISPATCH_NUM_RUNS; i++) {
+            uint64_t cycles = read_cycle_counter();
+            api->sign(&sk[b], &pk[b], message, sizeof(message), &sig[b]);
+            welford_update(&timer_sign,(read_cycle_counter()-cycles)/1000.0);
+
+            cycles = read_cycle_counter();
+            is_dispatch_ok &= api->verify(&pk[b], message, sizeof(message), &sig[b]) == 1;
+            welford_update(&timer_verify,(read_cycle_counter()-cycles)/1000.0);
+        }
+        printf("%s,sign,", api->name);
+        welford_print(timer_sign);
+        printf("\n%s,verify,", api->name);
+        welford_print(timer_verify);
+        printf("\n");
+
+        if (reference < 0) {
+            reference = b;
+        } else {
+            is_dispatch_ok &= memcmp(&sk[reference], &sk[b], sizeof(speck_prikey_t)) == 0;
+            is_dispatch_ok &= memcmp(&pk[reference], &pk[b], sizeof(speck_pubkey_t)) == 0;
+            is_dispatch_ok &= memcmp(&sig[reference], &sig[b], sizeof(speck_sign_t)) == 0;
+        }
+    }
+
+    /* the entry points of the API forward to the selected backend */
+    static speck_prikey_t sk_api;
+    static speck_pubkey_t pk_api;
+    static speck_sign_t sig_api;
+    SPECK_init_randombytes((const unsigned char *)"0123456789012345",16);
+    SPECK_keygen(&sk_api, &pk_api);
+    SPECK_sign(&sk_api, &pk_api, message, sizeof(message), &sig_api);
+    is_dispatch_ok &= SPECK_verify(&pk_api, message, sizeof(message), &sig_api) == 1;
+    is_dispatch_ok &= memcmp(&pk_api, &pk[backend], sizeof(speck_pubkey_t)) == 0;
+
+    fprintf(stderr,"Backend dispatch: %s", is_dispatch_ok ? "functional\n": "not functional\n" );
+    return is_dispatch_ok ? 0 : 1;
+}
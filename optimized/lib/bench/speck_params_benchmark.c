@@ -0,0 +1,183 @@
+/**
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ''AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "speck_params.h"
+#include "cycles.h"
+
+#define PARAMS_NUM_RUNS 8
+
+typedef struct {
+    long double mean;
+    long double M2;
+    long count;
+} welford_t;
+
+static inline
+void welford_init(welford_t *state) {
+    state->mean = 0.0;
+    state->M2 = 0.0;
+    state->count = 0;
+    return;
+}
+
+static inline
+void welford_update(welford_t *state, long double sample) {
+    long double delta, delta2;
+    state->count = state->count + 1;
+    delta = sample - state->mean;
+    state->mean += delta / (long double)(state->count);
+    delta2 = sample - state->mean;
+    state->M2 += delta * delta2;
+}
+
+static inline
+void welford_print(const welford_t state) {
+    printf("%.2Lf,%.2Lf",
+           state.mean,
+           sqrtl(state.M2/(long double)(state.count-1)));
+}
+
+typedef struct {
+    const speck_params_t *params;
+    unsigned char *pk, *sk;
+    /* signed message of the last run */
+    unsigned char *sm;
+    unsigned long long smlen;
+} params_run_t;
+
+static const unsigned char seed[16] = "0123456789012345";
+static const unsigned char message[8] = "Signme!";
+
+/// samples the keypair of a parameter set from the fixed seed
+static
+void params_run_init(params_run_t *run, const speck_params_t *params) {
+    run->params = params;
+    run->pk = malloc(params->public_key_bytes);
+    run->sk = malloc(params->secret_key_bytes);
+    run->sm = malloc(sizeof(message) + params->signature_bytes);
+    params->init_randombytes(seed, sizeof(seed));
+    params->crypto_sign_keypair(run->pk, run->sk);
+}
+
+static
+void params_run_free(params_run_t *run) {
+    free(run->pk);
+    free(run->sk);
+    free(run->sm);
+}
+
+/// \return 1 if the message is signed, and the signature opens
+static
+int params_run_sign(params_run_t *run) {
+    const speck_params_t *params = run->params;
+    unsigned char opened[sizeof(message) + 1];
+    unsigned long long mlen;
+    params->crypto_sign(run->sm, &run->smlen, message, sizeof(message), run->sk, run->pk);
+    return run->smlen <= sizeof(message) + params->signature_bytes &&
+           params->crypto_sign_open(opened, &mlen, run->sm, run->smlen, run->pk) == 0 &&
+           mlen == sizeof(message) && memcmp(opened, message, sizeof(message)) == 0;
+}
+
+/* every parameter set of the library signs in turn, switching set at each
+ * call. Each instance has its own global CSPRNG: the keypairs and the
+ * signatures match the ones obtained running every set on its own, and the
+ * ones of the portable instances of the sets */
+int main(void) {
+    setup_cycle_counter();
+    fprintf(stderr,"SPECK parameter sets benchmarking tool\n");
+    const uint32_t num_params = SPECK_num_params();
+    int is_params_ok = num_params > 0;
+
+    printf("Parameter sets (name,backend,n,k,t,w,pk bytes,sk bytes,max sig bytes):\n");
+    for (uint32_t i = 0; i < num_params; i++) {
+        const speck_params_t *params = SPECK_params_at(i);
+        is_params_ok &= SPECK_params(params->t) == params &&
+                        SPECK_params_backend(params->t, params->backend) == params;
+        printf("%s,%s,%u,%u,%u,%u,%zu,%zu,%zu\n", params->name, params->backend,
+               params->n, params->k, params->t, params->w, params->public_key_bytes,
+               params->secret_key_bytes, params->signature_bytes);
+    }
+    is_params_ok &= SPECK_params(0) == NULL && SPECK_params_at(num_params) == NULL;
+
+    /* every set on its own */
+    params_run_t *alone = malloc(num_params * sizeof(params_run_t));
+    for (uint32_t i = 0; i < num_params; i++) {
+        params_run_init(&alone[i], SPECK_params_at(i));
+        for (int r = 0; r < PARAMS_NUM_RUNS; r++) {
+            is_params_ok &= params_run_sign(&alone[i]);
+        }
+    }
+
+    /* the portable instances, if not the selected ones */
+    for (uint32_t i = 0; i < num_params; i++) {
+        const speck_params_t *portable = SPECK_params_backend(alone[i].params->t, "portable");
+        is_params_ok &= portable != NULL;
+        if (portable == NULL || portable == alone[i].params) {
+            continue;
+        }
+        params_run_t run;
+        params_run_init(&run, portable);
+        for (int r = 0; r < PARAMS_NUM_RUNS; r++) {
+            is_params_ok &= params_run_sign(&run);
+        }
+        is_params_ok &= memcmp(alone[i].pk, run.pk, portable->public_key_bytes) == 0 &&
+                        memcmp(alone[i].sk, run.sk, portable->secret_key_bytes) == 0 &&
+                        alone[i].smlen == run.smlen &&
+                        memcmp(alone[i].sm, run.sm, run.smlen) == 0;
+        params_run_free(&run);
+    }
+
+    /* the sets interleaved, one call each */
+    params_run_t *interleaved = malloc(num_params * sizeof(params_run_t));
+    welford_t *timer_sign = malloc(num_params * sizeof(welford_t));
+    for (uint32_t i = 0; i < num_params; i++) {
+        params_run_init(&interleaved[i], SPECK_params_at(i));
+        welford_init(&timer_sign[i]);
+    }
+    for (int r = 0; r < PARAMS_NUM_RUNS; r++) {
+        for (uint32_t i = 0; i < num_params; i++) {
+            uint64_t cycles = read_cycle_counter();
+            is_params_ok &= params_run_sign(&interleaved[i]);
+            welford_update(&timer_sign[i],(read_cycle_counter()-cycles)/1000.0);
+        }
+    }
+
+    printf("Timings (kcycles) of sign and open, switching set per call (name,avg,stddev):\n");
+    for (uint32_t i = 0; i < num_params; i++) {
+        printf("%s,", interleaved[i].params->name);
+        welford_print(timer_sign[i]);
+        printf("\n");
+
+        const speck_params_t *params = interleaved[i].params;
+        is_params_ok &= memcmp(alone[i].pk, interleaved[i].pk, params->public_key_bytes) == 0;
+        is_params_ok &= memcmp(alone[i].sk, interleaved[i].sk, params->secret_key_bytes) == 0;
+        is_params_ok &= alone[i].smlen == interleaved[i].smlen &&
+                        memcmp(alone[i].sm, interleaved[i].sm, alone[i].smlen) == 0;
+        params_run_free(&alone[i]);
+        params_run_free(&interleaved[i]);
+    }
+    free(alone);
+    free(interleaved);
+    free(timer_sign);
+
+    fprintf(stderr,"Parameter sets: %s", is_params_ok ? "functional\n": "not functional\n" );
+    return is_params_ok ? 0 : 1;
+}
@@ -25,6 +25,7 @@
 #include "parameters.h"
 #include <assert.h>
 
+#ifdef USE_AVX2
 // Select low 8-bit, skip the high 8-bit in 16 bit type
 const uint8_t shuff_low_half[32] = {
         0x0, 0x2, 0x4, 0x6, 0x8, 0xa, 0xc, 0xe,
@@ -32,6 +33,7 @@ const uint8_t shuff_low_half[32] = {
         0x0, 0x2, 0x4, 0x6, 0x8, 0xa, 0xc, 0xe,
         0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
 };
+#endif
 
 /// swap N uint8 in r and s.
 /// \param r[in/out]
@@ -47,6 +49,7 @@ void swap_rows_old(FQ_ELEM r[N],
 
 void swap_rows(FQ_ELEM r[N_pad], 
                FQ_ELEM s[N_pad]){
+#ifdef USE_AVX2
     vec256_t a, b;
     for(uint32_t i=0; i<N_pad; i+=32) {
          vload256(a, (const vec256_t *)(r + i));
@@ -54,6 +57,13 @@ void swap_rows(FQ_ELEM r[N_pad],
          vstore256((vec256_t *)(r + i), b);
          vstore256((vec256_t *)(s + i), a);
     }
+#else
+    for(uint32_t i=0; i<N_pad; i++) {
+         const FQ_ELEM t = r[i];
+         r[i] = s[i];
+         s[i] = t;
+    }
+#endif
 } /* end swap_rows */
 
 
@@ -69,6 +79,7 @@ void generator_get_pivot_flags(const rref_generator_mat_t *const G,
     }
 }
 
+#ifdef USE_AVX2
 int generator_RREF(generator_mat_t *G, uint8_t is_pivot_column[N_pad]) {
     int i, j, pivc;
     uint8_t tmp, sc;
@@ -170,6 +181,53 @@ int generator_RREF(generator_mat_t *G, uint8_t is_pivot_column[N_pad]) {
 
     return 1;
 } /* end generator_RREF */
+#else
+/// same pivoting as the vector version above, all the N_pad columns of a
+/// row are rescaled and subtracted
+int generator_RREF(generator_mat_t *G, uint8_t is_pivot_column[N_pad]) {
+    for (uint32_t i = 0; i < K; i++) {
+        uint32_t j = i;
+        uint32_t pivc = i;
+        /* first column from the i-th one with a non zero in rows i..K-1 */
+        while (pivc < N) {
+            while (j < K && G->values[j][pivc] == 0) {
+                j++;
+            }
+            if (j < K) {
+                break;
+            }
+            pivc++;
+            j = i;
+        }
+
+        if (pivc >= N) {
+            /* no pivot candidates left, report failure */
+            return 0;
+        }
+        is_pivot_column[pivc] = 1;
+
+        if (i != j) {
+            swap_rows(G->values[i], G->values[j]);
+        }
+
+        const FQ_ELEM scaling_factor = fq_inv(G->values[i][pivc]);
+        for (uint32_t k = 0; k < N_pad; k++) {
+            G->values[i][k] = fq_mul(scaling_factor, G->values[i][k]);
+        }
+
+        for (j = 0; j < K; j++) {
+            const FQ_ELEM multiplier = G->values[j][pivc];
+            if (j != i && multiplier != 0) {
+                for (uint32_t k = 0; k < N_pad; k++) {
+                    G->values[j][k] = fq_sub(G->values[j][k], fq_mul(multiplier, G->values[i][k]));
+                }
+            }
+        }
+    }
+
+    return 1;
+} /* end generator_RREF */
+#endif
 
 /// \param G[in/out]: generator matrix K \times N
 /// \param is_pivot_column[out]: N bytes, set to 1 if this column
@@ -563,14 +621,15 @@ void swap_columns(FQ_ELEM M[K][K_pad], uint8_t c1, uint8_t c2, uint8_t r){
 /// \param res[out]: full rank generator matrix K \times K
 /// \param seed[int] seed for the prng
 void antiorthogonal_sample(FQ_ELEM A[K][K_pad], const unsigned char seed[SEED_LENGTH_BYTES]) {
-    SHAKE_STATE_STRUCT csprng_state;
-    initialize_csprng(&csprng_state, seed, SEED_LENGTH_BYTES);
+    csprng_reader_t csprng_reader;
+    csprng_reader_init(&csprng_reader, seed, SEED_LENGTH_BYTES);
     FQ_ELEM G[K_pad][K_pad] __attribute__((aligned(32))) = {0};
-    FQ_ELEM c[K_pad];
+    /* anti_normalize reads the padding of c as well, which is never written */
+    FQ_ELEM c[K_pad] = {0};
 
     c[0] = 0;
     while(c[0] == 0 || !(anti_normalize(c))){
-        rand_range_q_state_elements(&csprng_state, c, K);
+        rand_range_q_reader_elements(&csprng_reader, c, K);
     }
 
     set_row(A[0],c);
@@ -595,7 +654,7 @@ void antiorthogonal_sample(FQ_ELEM A[K][K_pad], const unsigned char seed[SEED_LE
         FQ_ELEM u[K-kp];
 
         do{
-            rand_range_q_state_elements(&csprng_state, u, K-kp);
+            rand_range_q_reader_elements(&csprng_reader, u, K-kp);
             //row_mat_mult(c,u,M,K-kp,kp);
             row_mat_mult_opp_tran(c,u,M,K-kp,kp,kp);
             memcpy(c+kp, u, sizeof(FQ_ELEM)*(K-kp));
@@ -0,0 +1,194 @@
+/**
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ''AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **/
+
+/* this translation unit runs before the CPU is known to support AVX2: it
+ * must be compiled with the flags of the portable backend */
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dispatch.h"
+#include "api.h"
+#include "cpu_features.h"
+
+/* entry points of a backend, as renamed by cmake/namespace_backend.cmake */
+#define BACKEND_DECLARE(prefix)                                                \
+   extern SHAKE_STATE_STRUCT prefix##platform_csprng_state;                    \
+   void prefix##initialize_csprng(SHAKE_STATE_STRUCT *shake_state,             \
+                                  const unsigned char *seed,                   \
+                                  const uint32_t seed_len_bytes);              \
+   void prefix##SPECK_keygen(speck_prikey_t *SK, speck_pubkey_t *PK);          \
+   size_t prefix##SPECK_sign(const speck_prikey_t *SK,                         \
+                             const speck_pubkey_t *PK,                         \
+                             const char *const m, const uint64_t mlen,         \
+                             speck_sign_t *sig);                               \
+   size_t prefix##SPECK_sign_mt(const speck_prikey_t *SK,                      \
+                                const speck_pubkey_t *PK,                      \
+                                const char *const m, const uint64_t mlen,      \
+                                speck_sign_t *sig, uint32_t num_threads);      \
+   int prefix##SPECK_verify(const speck_pubkey_t *const PK,                    \
+                            const char *const m, const uint64_t mlen,          \
+                            const speck_sign_t *const sig);                    \
+   int prefix##SPECK_verify_mt(const speck_pubkey_t *const PK,                 \
+                               const char *const m, const uint64_t mlen,       \
+                               const speck_sign_t *const sig,                  \
+                               uint32_t num_threads);                          \
+   int prefix##crypto_sign_keypair(unsigned char *pk, unsigned char *sk);      \
+   int prefix##crypto_sign(unsigned char *sm, unsigned long long *smlen,       \
+                           const unsigned char *m, unsigned long long mlen,    \
+                           const unsigned char *sk, const unsigned char *pk);  \
+   int prefix##crypto_sign_open(unsigned char *m, unsigned long long *mlen,    \
+                                const unsigned char *sm,                       \
+                                unsigned long long smlen,                      \
+                                const unsigned char *pk);
+
+#define BACKEND_API(prefix, backend_name) {                                    \
+   .name = backend_name,                                                       \
+   .csprng_state = &prefix##platform_csprng_state,                             \
+   .initialize_csprng = prefix##initialize_csprng,                             \
+   .keygen = prefix##SPECK_keygen,                                             \
+   .sign = prefix##SPECK_sign,                                                 \
+   .sign_mt = prefix##SPECK_sign_mt,                                           \
+   .verify = prefix##SPECK_verify,                                             \
+   .verify_mt = prefix##SPECK_verify_mt,                                       \
+   .crypto_sign_keypair = prefix##crypto_sign_keypair,                         \
+   .crypto_sign = prefix##crypto_sign,                                         \
+   .crypto_sign_open = prefix##crypto_sign_open,                               \
+}
+
+BACKEND_DECLARE(speck_portable_)
+BACKEND_DECLARE(speck_avx2_)
+
+static const speck_backend_api_t backends[SPECK_NUM_BACKENDS] = {
+   [SPECK_BACKEND_PORTABLE] = BACKEND_API(speck_portable_, "portable"),
+   [SPECK_BACKEND_AVX2] = BACKEND_API(speck_avx2_, "avx2"),
+};
+
+static pthread_once_t backend_once = PTHREAD_ONCE_INIT;
+static speck_backend_t selected_backend = SPECK_BACKEND_PORTABLE;
+
+/// \return: 1 if the host executes the instructions of the backend
+static
+int backend_supported(speck_backend_t backend) {
+   switch (backend) {
+   case SPECK_BACKEND_PORTABLE:
+      return 1;
+   case SPECK_BACKEND_AVX2:
+      return cpu_supports_avx2();
+   default:
+      return 0;
+   }
+}
+
+static
+void backend_resolve(void) {
+   const char *forced = getenv("SPECK_BACKEND");
+   if (forced != NULL) {
+      for (int b = 0; b < SPECK_NUM_BACKENDS; b++) {
+         if (strcmp(forced, backends[b].name) == 0 && backend_supported(b)) {
+            selected_backend = b;
+            return;
+         }
+      }
+      selected_backend = SPECK_BACKEND_PORTABLE;
+      return;
+   }
+   selected_backend = backend_supported(SPECK_BACKEND_AVX2) ? SPECK_BACKEND_AVX2
+                                                            : SPECK_BACKEND_PORTABLE;
+} /* end backend_resolve */
+
+speck_backend_t SPECK_backend(void) {
+   pthread_once(&backend_once, backend_resolve);
+   return selected_backend;
+}
+
+const char *SPECK_backend_name(speck_backend_t backend) {
+   return (backend < SPECK_NUM_BACKENDS) ? backends[backend].name : "unknown";
+}
+
+const speck_backend_api_t *SPECK_backend_api(speck_backend_t backend) {
+   return (backend < SPECK_NUM_BACKENDS && backend_supported(backend)) ? &backends[backend] : NULL;
+}
+
+static inline
+const speck_backend_api_t *selected(void) {
+   return &backends[SPECK_backend()];
+}
+
+void SPECK_init_randombytes(const unsigned char *seed,
+                            const uint32_t seed_len_bytes) {
+   const speck_backend_api_t *api = selected();
+   api->initialize_csprng(api->csprng_state, seed, seed_len_bytes);
+}
+
+void SPECK_keygen(speck_prikey_t *SK,
+                  speck_pubkey_t *PK) {
+   selected()->keygen(SK, PK);
+}
+
+size_t SPECK_sign(const speck_prikey_t *SK,
+                  const speck_pubkey_t *PK,
+                  const char *const m,
+                  const uint64_t mlen,
+                  speck_sign_t *sig) {
+   return selected()->sign(SK, PK, m, mlen, sig);
+}
+
+size_t SPECK_sign_mt(const speck_prikey_t *SK,
+                     const speck_pubkey_t *PK,
+                     const char *const m,
+                     const uint64_t mlen,
+                     speck_sign_t *sig,
+                     uint32_t num_threads) {
+   return selected()->sign_mt(SK, PK, m, mlen, sig, num_threads);
+}
+
+int SPECK_verify(const speck_pubkey_t *const PK,
+                 const char *const m,
+                 const uint64_t mlen,
+                 const speck_sign_t *const sig) {
+   return selected()->verify(PK, m, mlen, sig);
+}
+
+int SPECK_verify_mt(const speck_pubkey_t *const PK,
+                    const char *const m,
+                    const uint64_t mlen,
+                    const speck_sign_t *const sig,
+                    uint32_t num_threads) {
+   return selected()->verify_mt(PK, m, mlen, sig, num_threads);
+}
+
+int crypto_sign_keypair(unsigned char *pk,
+                        unsigned char *sk) {
+   return selected()->crypto_sign_keypair(pk, sk);
+}
+
+int crypto_sign(unsigned char *sm,
+                unsigned long long *smlen,
+                const unsigned char *m,
+                unsigned long long mlen,
+                const unsigned char *sk,
+                const unsigned char *pk) {
+   return selected()->crypto_sign(sm, smlen, m, mlen, sk, pk);
+}
+
+int crypto_sign_open(unsigned char *m,
+                     unsigned long long *mlen,
+                     const unsigned char *sm,
+                     unsigned long long smlen,
+                     const unsigned char *pk) {
+   return selected()->crypto_sign_open(m, mlen, sm, smlen, pk);
+}
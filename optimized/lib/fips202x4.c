@@ -43,77 +43,129 @@
  * 
  */
 
-#include <assert.h>
 #include <stdint.h>
-#include <stdlib.h>
 #include <string.h>
 
 #include "fips202x4.h"
 
 void keccak_x4_init(par_keccak_context *ctx)
+{
+    keccak_x4_init_rate(ctx, RATE);
+}
+
+void keccak_x4_init_rate(par_keccak_context *ctx, unsigned int rate)
 {
     /* zero the states */
     KeccakP1600times4_InitializeAll(&ctx->state);
     ctx->offset = 0;
+    ctx->rate = rate;
+}
+
+/* xors "length" bytes of each input into the rate of the four instances,
+ * starting at byte "offset"; offset + length must not exceed the rate.
+ * Lane i of instance j is the 64-bit word 4*i+j of the interleaved state */
+static void add_bytes_x4(KeccakP1600times4_states *states, const unsigned char *in[4], unsigned int offset, unsigned int length)
+{
+    uint64_t *lanes = (uint64_t *)states->A;
+    unsigned int lane = offset / (WORD / 8);
+    unsigned int lane_offset = offset % (WORD / 8);
+    unsigned int done = 0;
+    /* head: completes the lane partially filled by a previous call */
+    if(lane_offset != 0 && length > 0) {
+        done = (WORD / 8) - lane_offset;
+        if(done > length) {
+            done = length;
+        }
+        for(int instance=0; instance<4; instance++) {
+            uint64_t word = 0;
+            memcpy((unsigned char *)&word + lane_offset, in[instance], done);
+            lanes[4 * lane + instance] ^= word;
+        }
+        lane++;
+    }
+    /* body: one whole lane of all the four instances per vector xor */
+    for(; length - done >= (WORD / 8); done += (WORD / 8), lane++) {
+        uint64_t words[4];
+        for(int instance=0; instance<4; instance++) {
+            memcpy(&words[instance], in[instance] + done, (WORD / 8));
+        }
+#ifdef USE_AVX2
+        states->A[lane] = _mm256_xor_si256(states->A[lane],
+                                           _mm256_set_epi64x(words[3], words[2], words[1], words[0]));
+#else
+        for(int instance=0; instance<4; instance++) {
+            lanes[4 * lane + instance] ^= words[instance];
+        }
+#endif
+    }
+    /* tail: the last partial lane, zero padded */
+    if(done < length) {
+        for(int instance=0; instance<4; instance++) {
+            uint64_t word = 0;
+            memcpy(&word, in[instance] + done, length - done);
+            lanes[4 * lane + instance] ^= word;
+        }
+    }
+}
+
+/* copies "length" bytes of the rate of the four instances, starting at byte
+ * "offset", to the four outputs; offset + length must not exceed the rate */
+static void extract_bytes_x4(const KeccakP1600times4_states *states, unsigned char *out[4], unsigned int offset, unsigned int length)
+{
+    const uint64_t *lanes = (const uint64_t *)states->A;
+    unsigned int lane = offset / (WORD / 8);
+    unsigned int lane_offset = offset % (WORD / 8);
+    unsigned int done = 0;
+    if(lane_offset != 0 && length > 0) {
+        done = (WORD / 8) - lane_offset;
+        if(done > length) {
+            done = length;
+        }
+        for(int instance=0; instance<4; instance++) {
+            memcpy(out[instance], (const unsigned char *)&lanes[4 * lane + instance] + lane_offset, done);
+        }
+        lane++;
+    }
+    for(; length - done >= (WORD / 8); done += (WORD / 8), lane++) {
+        for(int instance=0; instance<4; instance++) {
+            memcpy(out[instance] + done, &lanes[4 * lane + instance], (WORD / 8));
+        }
+    }
+    if(done < length) {
+        for(int instance=0; instance<4; instance++) {
+            memcpy(out[instance] + done, &lanes[4 * lane + instance], length - done);
+        }
+    }
 }
 
 void keccak_x4_absorb(par_keccak_context *ctx, const unsigned char *in1, const unsigned char *in2, const unsigned char *in3, const unsigned char *in4, unsigned int in_len)
 {
-    /* allocate a signle buffer for all 4 inputs */
-    unsigned int total_len = 4 * in_len;
-    unsigned char *ins = (unsigned char *)malloc(total_len * sizeof(unsigned char));
-    assert(ins != NULL);
-    uint8_t* original_ins = ins; // to free the memory later
-    memcpy(ins, in1, in_len);
-    memcpy(ins + in_len, in2, in_len);
-    memcpy(ins + 2 * in_len, in3, in_len);
-    memcpy(ins + 3 * in_len, in4, in_len);
-    /* if both these conditions are verified:
-     * - there are no bytes left from the previous input (offset == 0)
-     * - the new input size is a multiple of the lane size
-     * then absorb in parallel using AddLanesAll
-     * otherwise, absorb serially using AddBytes */
-    if(ctx->offset == 0 && in_len % (WORD / 8) == 0) {
-        int lanes = in_len * 8 / WORD;
-        int lane_offset = lanes;
-        while(lanes > 0) {
-            if(lanes >= MAX_LANES) {
-                KeccakP1600times4_AddLanesAll(&ctx->state, ins, MAX_LANES, lane_offset);
-                KeccakP1600times4_PermuteAll_24rounds(&ctx->state);
-                lanes -= MAX_LANES;
-                ins += MAX_LANES * WORD / 8;
-                ctx->offset = 0;
-            } else {
-                KeccakP1600times4_AddLanesAll(&ctx->state, ins, lanes, lane_offset);
-                ctx->offset = lanes * WORD / 8;
-                lanes = 0;
-            }
+    /* absorb straight from the inputs, at most up to the end of the rate at
+     * a time; a full rate is permuted right away */
+    const unsigned char *ins[4] = {in1, in2, in3, in4};
+    while(in_len > 0) {
+        unsigned int len = ctx->rate - ctx->offset;
+        if(len > in_len) {
+            len = in_len;
         }
-    } else {
-        /* if there are enough bytes to fill the rate, absorb then permute */
-        while (in_len + ctx->offset >= RATE) {
-            for(int instance=0; instance<4; instance++) {
-                KeccakP1600times4_AddBytes(&ctx->state, instance, ins+instance*(total_len/4), ctx->offset, RATE - ctx->offset);
-            }
-            in_len -= RATE - ctx->offset;
-            ins += RATE - ctx->offset;
+        add_bytes_x4(&ctx->state, ins, ctx->offset, len);
+        for(int instance=0; instance<4; instance++) {
+            ins[instance] += len;
+        }
+        in_len -= len;
+        ctx->offset += len;
+        if(ctx->offset == ctx->rate) {
             KeccakP1600times4_PermuteAll_24rounds(&ctx->state);
             ctx->offset = 0;
         }
-        /* if there are any bytes left, absorb them */
-        for(int instance=0; instance<4; instance++) {
-            KeccakP1600times4_AddBytes(&ctx->state, instance, ins+instance*(total_len/4), ctx->offset, in_len);
-        }
-        ctx->offset += in_len;
     }
-    free(original_ins); 
 }
 
 void keccak_x4_finalize(par_keccak_context *ctx)
 {
     /* add the domain separator */
     uint8_t ds = DS;
-    if(ctx->offset == RATE - 1) {
+    if(ctx->offset == ctx->rate - 1) {
         ds |= 128;
         for(int instance=0; instance<4; instance++) {
             KeccakP1600times4_AddBytes(&ctx->state, instance, &ds, ctx->offset, 1);
@@ -124,74 +176,92 @@ void keccak_x4_finalize(par_keccak_context *ctx)
         }
         ds = 128;
         for(int instance=0; instance<4; instance++) {
-            KeccakP1600times4_AddBytes(&ctx->state, instance, &ds, RATE - 1, 1);
+            KeccakP1600times4_AddBytes(&ctx->state, instance, &ds, ctx->rate - 1, 1);
         }
     }
     ctx->offset = 0;
 }
 
-void keccak_x4_squeeze(par_keccak_context *ctx, unsigned char *out1, unsigned char *out2, unsigned char *out3, unsigned char *out4, unsigned int out_len)
+/* lanes of the largest rate, the one of SHAKE128 */
+#define MAX_RATE_LANES (SHAKE128_RATE / (WORD / 8))
+
+/* absorbs in||tail and the padding in exactly "blocks" blocks: each one is
+ * laid out in a zeroed buffer holding the four instances one rate apart,
+ * which is xored with a single AddLanesAll. The last block is not permuted,
+ * as after keccak_x4_finalize */
+static inline void absorb_final_blocks(par_keccak_context *ctx, const unsigned char *const in[4], unsigned int in_len, const unsigned char *const tail[4], unsigned int tail_len, const unsigned int blocks)
 {
-    /* allocate a signle buffer for all 4 outputs */
-    unsigned int total_len = 4 * out_len;
-    unsigned char *outs = (unsigned char *)malloc(total_len * sizeof(unsigned char));
-    uint8_t* original_outs = outs; // to free the memory later
-    int original_out_len = out_len;
-    /* if both these conditions are verified:
-     * - there are no bytes left from the previous extraction (offset == 0)
-     * - the new output size is a multiple of the lane size
-     * then extract in parallel using ExtractLanesAll
-     * otherwise, extract serially using ExtractBytes */
-    if(ctx->offset == 0 && out_len % (WORD / 8) == 0) {
-        int lanes = out_len * 8 / WORD;
-        int lane_offset = lanes;
-        while(lanes > 0) {
-            KeccakP1600times4_PermuteAll_24rounds(&ctx->state);
-            if(lanes >= MAX_LANES) {
-                KeccakP1600times4_ExtractLanesAll(&ctx->state, outs, MAX_LANES, lane_offset);
-                lanes -= MAX_LANES;
-                outs += MAX_LANES * WORD / 8;
-                ctx->offset = 0;
-            } else {
-                KeccakP1600times4_ExtractLanesAll(&ctx->state, outs, lanes, lane_offset);
-                ctx->offset = RATE - (lanes * WORD / 8);
-                lanes = 0;
+    uint64_t block_lanes[4 * MAX_RATE_LANES];
+    unsigned char *block = (unsigned char *)block_lanes;
+    const unsigned int rate = ctx->rate;
+    unsigned int pos = ctx->offset;
+    unsigned int in_done = 0, tail_done = 0;
+    for(unsigned int b = 0; b < blocks; b++) {
+        memset(block, 0, 4 * rate);
+        unsigned int len = rate - pos < in_len - in_done ? rate - pos : in_len - in_done;
+        for(int instance=0; instance<4; instance++) {
+            memcpy(block + instance * rate + pos, in[instance] + in_done, len);
+        }
+        pos += len;
+        in_done += len;
+        len = rate - pos < tail_len - tail_done ? rate - pos : tail_len - tail_done;
+        for(int instance=0; instance<4; instance++) {
+            memcpy(block + instance * rate + pos, tail[instance] + tail_done, len);
+        }
+        pos += len;
+        tail_done += len;
+        if(b == blocks - 1) {
+            for(int instance=0; instance<4; instance++) {
+                block[instance * rate + pos] ^= DS;
+                block[instance * rate + rate - 1] ^= 128;
             }
         }
+        KeccakP1600times4_AddLanesAll(&ctx->state, block, rate / (WORD / 8), rate / (WORD / 8));
+        if(b < blocks - 1) {
+            KeccakP1600times4_PermuteAll_24rounds(&ctx->state);
+            pos = 0;
+        }
+    }
+    ctx->offset = 0;
+}
+
+void keccak_x4_absorb_final(par_keccak_context *ctx, const unsigned char *const in[4], unsigned int in_len, const unsigned char *const tail[4], unsigned int tail_len)
+{
+    /* the padding takes at least one byte after the input */
+    const unsigned int blocks = (ctx->offset + in_len + tail_len) / ctx->rate + 1;
+    /* the commitments and the seed expansions end within one or two blocks */
+    if(blocks == 1) {
+        absorb_final_blocks(ctx, in, in_len, tail, tail_len, 1);
+    } else if(blocks == 2) {
+        absorb_final_blocks(ctx, in, in_len, tail, tail_len, 2);
     } else {
-        int len;
-        if (out_len < ctx->offset) {
+        keccak_x4_absorb(ctx, in[0], in[1], in[2], in[3], in_len);
+        keccak_x4_absorb(ctx, tail[0], tail[1], tail[2], tail[3], tail_len);
+        keccak_x4_finalize(ctx);
+    }
+}
+
+void keccak_x4_squeeze(par_keccak_context *ctx, unsigned char *out1, unsigned char *out2, unsigned char *out3, unsigned char *out4, unsigned int out_len)
+{
+    /* deinterleave straight into the outputs, permuting whenever no
+     * squeezed bytes are left */
+    unsigned char *outs[4] = {out1, out2, out3, out4};
+    while(out_len > 0) {
+        if(ctx->offset == 0) {
+            KeccakP1600times4_PermuteAll_24rounds(&ctx->state);
+            ctx->offset = ctx->rate;
+        }
+        unsigned int len = ctx->offset;
+        if(len > out_len) {
             len = out_len;
-        } else {
-            len = ctx->offset;
         }
+        extract_bytes_x4(&ctx->state, outs, ctx->rate - ctx->offset, len);
         for(int instance=0; instance<4; instance++) {
-            KeccakP1600times4_ExtractBytes(&ctx->state, instance, outs+instance*(total_len/4), RATE - ctx->offset, len);
+            outs[instance] += len;
         }
-        outs += len;
         out_len -= len;
         ctx->offset -= len;
-        while(out_len > 0) {
-            KeccakP1600times4_PermuteAll_24rounds(&ctx->state);
-            if(out_len < RATE) {
-                len = out_len;
-            } else {
-                len = RATE;
-            }
-            for(int instance=0; instance<4; instance++) {
-                KeccakP1600times4_ExtractBytes(&ctx->state, instance, outs+instance*(total_len/4), 0, len);
-            }
-            outs += len;
-            out_len -= len;
-            ctx->offset = RATE - len;
-        }
     }
-    memcpy(out1, original_outs, (total_len/4));
-    memcpy(out2, original_outs+original_out_len, (total_len/4));
-    memcpy(out3, original_outs+original_out_len*2, (total_len/4));
-    memcpy(out4, original_outs+original_out_len*3, (total_len/4));
-    free(original_outs);
-    
 }
 
 
@@ -0,0 +1,53 @@
+/**
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ''AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **/
+
+/* the handle of the parameter set of this build, compiled with the rest of
+ * the scheme for every TARGET and backend of the library (see
+ * include/speck_params.h) */
+#include "speck_params.h"
+#include "api.h"
+#include "rng.h"
+
+#ifdef USE_AVX2
+#define PARAMS_BACKEND "avx2"
+#else
+#define PARAMS_BACKEND "portable"
+#endif
+
+#define PARAMS_STR_(x) #x
+#define PARAMS_STR(x) PARAMS_STR_(x)
+
+static
+void instance_init_randombytes(const unsigned char *seed,
+                               const uint32_t seed_len_bytes) {
+   init_randombytes(seed, seed_len_bytes);
+}
+
+const speck_params_t SPECK_params_instance = {
+   .name = "SPECK-" PARAMS_STR(CATEGORY) "-" PARAMS_STR(TARGET),
+   .backend = PARAMS_BACKEND,
+   .n = N,
+   .k = K,
+   .t = T,
+   .w = W,
+   .public_key_bytes = CRYPTO_PUBLICKEYBYTES,
+   .secret_key_bytes = CRYPTO_SECRETKEYBYTES,
+   .signature_bytes = CRYPTO_BYTES,
+   .init_randombytes = instance_init_randombytes,
+   .crypto_sign_keypair = crypto_sign_keypair,
+   .crypto_sign = crypto_sign,
+   .crypto_sign_open = crypto_sign_open,
+};
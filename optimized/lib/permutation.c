@@ -81,6 +81,36 @@ void yt_shuffle_state(SHAKE_STATE_STRUCT *shake_monomial_state, POSITION_T permu
       permutation[x] = tmp;
    } 
 }
+
+/// same as yt_shuffle_state, reading the words from a buffered reader
+/// \param reader[in/out]:
+/// \param permutation[in/out]: random permutation. Must be initialized with
+///         [0,....,n-1]
+void yt_shuffle_reader(csprng_reader_t *reader, POSITION_T permutation[N]) {
+   uint64_t rand_u64;
+   POSITION_T tmp;
+   POSITION_T x;
+   int c;
+
+   rand_u64 = csprng_reader_next_word(reader);
+   c = 0;
+
+   for (int i = 0; i < N; i++) {
+      do {
+         if (c == (64/POS_BITS)-1) {
+            rand_u64 = csprng_reader_next_word(reader);
+            c = 0;
+         }
+         x = rand_u64 & (POS_MASK);
+         rand_u64 = rand_u64 >> POS_BITS;
+         c = c + 1;
+      } while (x >= N);
+
+      tmp = permutation[i];
+      permutation[i] = permutation[x];
+      permutation[x] = tmp;
+   } 
+}
 /* FY shuffle on the permutation, sampling from the global TRNG state */
 void yt_shuffle(POSITION_T permutation[N]) {
     yt_shuffle_state(&platform_csprng_state, permutation);
@@ -93,13 +123,13 @@ void yt_shuffle(POSITION_T permutation[N]) {
 /// \param seed[in]: the seed
 void permutation_sample_prikey(permutation_t *res,
                             const unsigned char seed[PRIVATE_KEY_SEED_LENGTH_BYTES]) {
-    SHAKE_STATE_STRUCT shake_monomial_state = {0};
-    initialize_csprng(&shake_monomial_state, seed, PRIVATE_KEY_SEED_LENGTH_BYTES);
+    csprng_reader_t shake_monomial_reader;
+    csprng_reader_init(&shake_monomial_reader, seed, PRIVATE_KEY_SEED_LENGTH_BYTES);
     for (uint32_t i = 0; i < N; i++) {
         res->values[i] = i;
     }
     /* FY shuffle on the permutation */
-    yt_shuffle_state(&shake_monomial_state, res->values);
+    yt_shuffle_reader(&shake_monomial_reader, res->values);
 } 
 
 /// \param res[out]: = to_invert**-1
@@ -126,33 +156,75 @@ void word_permutation_sample_salt(
                           const unsigned char seed[SEED_LENGTH_BYTES],
                           const unsigned char salt[HASH_DIGEST_LENGTH],
                           const uint16_t round_index) {
-    SHAKE_STATE_STRUCT shake_monomial_state = {0};
+    csprng_reader_t shake_monomial_reader;
     const int shake_buffer_len = SEED_LENGTH_BYTES + HASH_DIGEST_LENGTH + sizeof(uint16_t);
     uint8_t shake_input_buffer[shake_buffer_len];
     memcpy(shake_input_buffer, seed, SEED_LENGTH_BYTES);
     memcpy(shake_input_buffer + SEED_LENGTH_BYTES, salt, HASH_DIGEST_LENGTH);
     memcpy(shake_input_buffer + SEED_LENGTH_BYTES + HASH_DIGEST_LENGTH, &round_index, sizeof(uint16_t));
 
-    initialize_csprng(&shake_monomial_state, shake_input_buffer, shake_buffer_len);
-    fq_star_rnd_state_elements(&shake_monomial_state, u, K);
+    csprng_reader_init(&shake_monomial_reader, shake_input_buffer, shake_buffer_len);
+    fq_star_rnd_reader_elements(&shake_monomial_reader, u, K);
     for (uint32_t i = 0; i < N; i++) {
         res->values[i] = i;
     }
     /* FY shuffle on the permutation */
-    yt_shuffle_state(&shake_monomial_state, res->values);
+    yt_shuffle_reader(&shake_monomial_reader, res->values);
 } /* end monomial_mat_seed_expand */
 
 void word_sample_salt(FQ_ELEM u[K],
                       const unsigned char seed[SEED_LENGTH_BYTES],
                       const unsigned char salt[HASH_DIGEST_LENGTH],
                       const uint16_t round_index) {
-    SHAKE_STATE_STRUCT shake_monomial_state = {0};
+    csprng_reader_t shake_monomial_reader;
     const int shake_buffer_len = SEED_LENGTH_BYTES + HASH_DIGEST_LENGTH + sizeof(uint16_t);
     uint8_t shake_input_buffer[shake_buffer_len];
     memcpy(shake_input_buffer, seed, SEED_LENGTH_BYTES);
     memcpy(shake_input_buffer + SEED_LENGTH_BYTES, salt, HASH_DIGEST_LENGTH);
     memcpy(shake_input_buffer + SEED_LENGTH_BYTES + HASH_DIGEST_LENGTH, &round_index, sizeof(uint16_t));
 
-    initialize_csprng(&shake_monomial_state, shake_input_buffer, shake_buffer_len);
-    fq_star_rnd_state_elements(&shake_monomial_state, u, K);
+    csprng_reader_init(&shake_monomial_reader, shake_input_buffer, shake_buffer_len);
+    fq_star_rnd_reader_elements(&shake_monomial_reader, u, K);
 } /* end monomial_mat_seed_expand */
+
+/* same as word_sample_salt on four rounds at once, with four SHAKE128
+ * instances computed by the x4 Keccak; each instance is squeezed block by
+ * block until its rejection sampling is done */
+void word_sample_salt_x4(FQ_ELEM *const u[4],
+                         const unsigned char *const seed[4],
+                         const unsigned char salt[HASH_DIGEST_LENGTH],
+                         const uint16_t round_index[4]) {
+    const FQ_ELEM SPAN = (Q-1) - 1;
+    const uint32_t REQ_BITS = BITS_TO_REPRESENT(SPAN);
+    csprng_x4_reader_t shake_monomial_reader;
+    const int shake_buffer_len = SEED_LENGTH_BYTES + HASH_DIGEST_LENGTH + sizeof(uint16_t);
+    uint8_t shake_input_buffer[4][shake_buffer_len];
+    for (uint32_t j = 0; j < 4; j++) {
+        memcpy(shake_input_buffer[j], seed[j], SEED_LENGTH_BYTES);
+        memcpy(shake_input_buffer[j] + SEED_LENGTH_BYTES, salt, HASH_DIGEST_LENGTH);
+        memcpy(shake_input_buffer[j] + SEED_LENGTH_BYTES + HASH_DIGEST_LENGTH, &round_index[j], sizeof(uint16_t));
+    }
+    csprng_x4_reader_init(&shake_monomial_reader,
+                          shake_input_buffer[0], shake_input_buffer[1],
+                          shake_input_buffer[2], shake_input_buffer[3],
+                          shake_buffer_len);
+
+    uint32_t count[4] = {0};
+    do {
+        csprng_x4_reader_refill(&shake_monomial_reader);
+        for (uint32_t j = 0; j < 4; j++) {
+#ifdef USE_AVX2
+            while (REQ_BITS == 7 && count[j] + 9 <= K &&
+                   csprng_x4_reader_has_word(&shake_monomial_reader, j)) {
+                count[j] += rnd_pack7_word(u[j] + count[j],
+                                           csprng_x4_reader_next_word(&shake_monomial_reader, j),
+                                           SPAN, 1);
+            }
+#endif
+            while (count[j] < K && csprng_x4_reader_has_bits(&shake_monomial_reader, j, REQ_BITS)) {
+                FQ_ELEM rnd_value = (FQ_ELEM) csprng_x4_reader_next_bits(&shake_monomial_reader, j, REQ_BITS);
+                if (rnd_value <= SPAN) u[j][count[j]++] = rnd_value + 1;
+            }
+        }
+    } while (count[0] < K || count[1] < K || count[2] < K || count[3] < K);
+} /* end word_sample_salt_x4 */
@@ -0,0 +1,249 @@
+/**
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ''AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **/
+#define _GNU_SOURCE // SCHED_IDLE
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "presign_pool.h"
+#include "rng.h"
+#include "utils.h"
+
+/* life cycle of a slot: the refill thread is the only one moving it from
+ * EMPTY to FILLING to READY, a signer claims it moving it from READY to
+ * TAKEN with a compare and swap, and releases it as EMPTY */
+#define SLOT_EMPTY   (0)
+#define SLOT_FILLING (1)
+#define SLOT_READY   (2)
+#define SLOT_TAKEN   (3)
+
+struct speck_presign_pool_s {
+    speck_prikey_t SK;
+    speck_pubkey_t PK;
+    uint32_t capacity;
+    size_t bundle_stride;
+    unsigned char *bundles_mem;
+    /* capacity slots, followed by the fallback bundle */
+    unsigned char *bundles;
+    uint32_t *slot_state;
+    /* slot where the next signer starts looking for a ready bundle */
+    uint32_t next_slot;
+    /* number of EMPTY slots, the refill thread sleeps on it */
+    sem_t empty_slots;
+    /* serializes the accesses to the global CSPRNG */
+    pthread_mutex_t rng_lock;
+    /* held by the signer employing the fallback bundle on a miss */
+    pthread_mutex_t fallback_lock;
+    pthread_t refill_thread;
+    int stop;
+
+    uint32_t depth;
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t refills;
+    uint64_t refill_ns_total;
+    uint64_t refill_ns_max;
+};
+
+static inline
+speck_bundle_t *pool_bundle(const speck_presign_pool_t *pool, uint32_t slot) {
+    return (speck_bundle_t *) (pool->bundles + slot * pool->bundle_stride);
+}
+
+static inline
+uint64_t elapsed_ns(const struct timespec *start, const struct timespec *end) {
+    return (uint64_t)(end->tv_sec - start->tv_sec) * 1000000000ull +
+           (uint64_t) end->tv_nsec - (uint64_t) start->tv_nsec;
+}
+
+/// draws the salt and the seed tree root of a signature from the global
+/// CSPRNG, and precomputes the bundle
+static
+void pool_precompute(speck_presign_pool_t *pool, speck_bundle_t *bundle) {
+    unsigned char salt[HASH_DIGEST_LENGTH];
+    unsigned char ephem_permutations_seed[SEED_LENGTH_BYTES];
+
+    pthread_mutex_lock(&pool->rng_lock);
+    randombytes(salt, HASH_DIGEST_LENGTH);
+    randombytes(ephem_permutations_seed, SEED_LENGTH_BYTES);
+    pthread_mutex_unlock(&pool->rng_lock);
+
+    SPECK_bundle_precompute_seeded(&pool->SK, &pool->PK, salt, ephem_permutations_seed, bundle);
+}
+
+static
+void *pool_refill(void *arg) {
+    speck_presign_pool_t *pool = (speck_presign_pool_t *) arg;
+#ifdef SCHED_IDLE
+    /* best effort: the thread keeps the default priority on failure */
+    struct sched_param param = {0};
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+
+    for (;;) {
+        while (sem_wait(&pool->empty_slots) != 0) {}
+        if (__atomic_load_n(&pool->stop, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+
+        /* the semaphore guarantees an EMPTY slot */
+        uint32_t slot = 0;
+        while (__atomic_load_n(&pool->slot_state[slot], __ATOMIC_ACQUIRE) != SLOT_EMPTY) {
+            slot = (slot + 1) % pool->capacity;
+        }
+        __atomic_store_n(&pool->slot_state[slot], SLOT_FILLING, __ATOMIC_RELAXED);
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        pool_precompute(pool, pool_bundle(pool, slot));
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        const uint64_t ns = elapsed_ns(&start, &end);
+        __atomic_fetch_add(&pool->refills, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&pool->refill_ns_total, ns, __ATOMIC_RELAXED);
+        /* the refill thread is the only writer of the maximum */
+        if (ns > __atomic_load_n(&pool->refill_ns_max, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&pool->refill_ns_max, ns, __ATOMIC_RELAXED);
+        }
+
+        __atomic_fetch_add(&pool->depth, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&pool->slot_state[slot], SLOT_READY, __ATOMIC_RELEASE);
+    }
+    return NULL;
+}
+
+/// \param SK[in]: secret key, copied in the pool
+/// \param PK[in]: public key, copied in the pool
+/// \param capacity[in]: number of bundles kept ready
+/// \return the pool, NULL on failure
+speck_presign_pool_t *SPECK_presign_pool_create(const speck_prikey_t *SK,
+                                                const speck_pubkey_t *PK,
+                                                uint32_t capacity) {
+    if (capacity == 0) {
+        return NULL;
+    }
+    speck_presign_pool_t *pool = calloc(1, sizeof(speck_presign_pool_t));
+    if (pool == NULL) {
+        return NULL;
+    }
+    memcpy(&pool->SK, SK, sizeof(speck_prikey_t));
+    memcpy(&pool->PK, PK, sizeof(speck_pubkey_t));
+    pool->capacity = capacity;
+    pool->bundle_stride = NEXT_MULTIPLE(SPECK_bundle_bytes(), SPECK_WORKSPACE_ALIGN);
+    pool->bundles_mem = malloc((capacity + 1) * pool->bundle_stride + SPECK_WORKSPACE_ALIGN);
+    pool->slot_state = calloc(capacity, sizeof(uint32_t));
+    if (pool->bundles_mem == NULL || pool->slot_state == NULL) {
+        goto fail_alloc;
+    }
+    pool->bundles = (unsigned char *) NEXT_MULTIPLE((uintptr_t) pool->bundles_mem, SPECK_WORKSPACE_ALIGN);
+
+    if (sem_init(&pool->empty_slots, 0, capacity) != 0) {
+        goto fail_alloc;
+    }
+    pthread_mutex_init(&pool->rng_lock, NULL);
+    pthread_mutex_init(&pool->fallback_lock, NULL);
+    if (pthread_create(&pool->refill_thread, NULL, pool_refill, pool) != 0) {
+        pthread_mutex_destroy(&pool->fallback_lock);
+        pthread_mutex_destroy(&pool->rng_lock);
+        sem_destroy(&pool->empty_slots);
+        goto fail_alloc;
+    }
+    return pool;
+
+fail_alloc:
+    free(pool->bundles_mem);
+    free(pool->slot_state);
+    wipe(pool, sizeof(speck_presign_pool_t));
+    free(pool);
+    return NULL;
+} /* end SPECK_presign_pool_create */
+
+void SPECK_presign_pool_destroy(speck_presign_pool_t *pool) {
+    __atomic_store_n(&pool->stop, 1, __ATOMIC_RELEASE);
+    sem_post(&pool->empty_slots);
+    pthread_join(pool->refill_thread, NULL);
+
+    pthread_mutex_destroy(&pool->fallback_lock);
+    pthread_mutex_destroy(&pool->rng_lock);
+    sem_destroy(&pool->empty_slots);
+    wipe(pool->bundles, (pool->capacity + 1) * pool->bundle_stride);
+    free(pool->bundles_mem);
+    free(pool->slot_state);
+    wipe(pool, sizeof(speck_presign_pool_t));
+    free(pool);
+} /* end SPECK_presign_pool_destroy */
+
+/// signs with a ready bundle if any, otherwise computes the whole signature
+/// \return: x: number of leaves opened by the algorithm
+size_t SPECK_presign_pool_sign(speck_presign_pool_t *pool,
+                               const char *const m,
+                               const uint64_t mlen,
+                               speck_sign_t *sig) {
+    const uint32_t first_slot = __atomic_fetch_add(&pool->next_slot, 1, __ATOMIC_RELAXED);
+    for (uint32_t i = 0; i < pool->capacity; i++) {
+        const uint32_t slot = (first_slot + i) % pool->capacity;
+        uint32_t expected = SLOT_READY;
+        if (__atomic_compare_exchange_n(&pool->slot_state[slot], &expected, SLOT_TAKEN,
+                                        0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            __atomic_fetch_sub(&pool->depth, 1, __ATOMIC_RELAXED);
+            const size_t num_seeds_published =
+                SPECK_sign_with_bundle(&pool->SK, m, mlen, sig, pool_bundle(pool, slot));
+
+            __atomic_store_n(&pool->slot_state[slot], SLOT_EMPTY, __ATOMIC_RELEASE);
+            sem_post(&pool->empty_slots);
+            __atomic_fetch_add(&pool->hits, 1, __ATOMIC_RELAXED);
+            return num_seeds_published;
+        }
+    }
+
+    /* no bundle ready: the signer computes its own one, in the fallback
+     * bundle of the pool if no other signer is employing it, otherwise in
+     * an allocated one, waiting for the fallback bundle only if the
+     * allocation fails */
+    __atomic_fetch_add(&pool->misses, 1, __ATOMIC_RELAXED);
+    unsigned char *bundle_mem = NULL;
+    speck_bundle_t *bundle = pool_bundle(pool, pool->capacity);
+    if (pthread_mutex_trylock(&pool->fallback_lock) != 0) {
+        bundle_mem = malloc(SPECK_bundle_bytes() + SPECK_WORKSPACE_ALIGN);
+        if (bundle_mem != NULL) {
+            bundle = (speck_bundle_t *) NEXT_MULTIPLE((uintptr_t) bundle_mem, SPECK_WORKSPACE_ALIGN);
+        } else {
+            pthread_mutex_lock(&pool->fallback_lock);
+        }
+    }
+    pool_precompute(pool, bundle);
+    const size_t num_seeds_published = SPECK_sign_with_bundle(&pool->SK, m, mlen, sig, bundle);
+    if (bundle_mem != NULL) {
+        free(bundle_mem);
+    } else {
+        pthread_mutex_unlock(&pool->fallback_lock);
+    }
+    return num_seeds_published;
+} /* end SPECK_presign_pool_sign */
+
+void SPECK_presign_pool_stats(speck_presign_pool_t *pool,
+                              speck_presign_pool_stats_t *stats) {
+    stats->capacity = pool->capacity;
+    stats->depth = __atomic_load_n(&pool->depth, __ATOMIC_RELAXED);
+    stats->hits = __atomic_load_n(&pool->hits, __ATOMIC_RELAXED);
+    stats->misses = __atomic_load_n(&pool->misses, __ATOMIC_RELAXED);
+    stats->refills = __atomic_load_n(&pool->refills, __ATOMIC_RELAXED);
+    stats->refill_ns_total = __atomic_load_n(&pool->refill_ns_total, __ATOMIC_RELAXED);
+    stats->refill_ns_max = __atomic_load_n(&pool->refill_ns_max, __ATOMIC_RELAXED);
+} /* end SPECK_presign_pool_stats */
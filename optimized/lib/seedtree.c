@@ -29,6 +29,73 @@
 #define SIBLING(i) ( ((i)%2) ? (i)+1 : (i)-1 )
 
 
+/* expands num <= 4 seeds of the nodes of the seed tree, each into the seeds
+ * of its two children stored contiguously, expanding the seed of the node,
+ * the salt and the node index for domain separation. Several nodes are
+ * expanded with the four SHAKE128 instances of the x4 Keccak; the lanes
+ * beyond num repeat the first node, and their children are dropped */
+static
+void expand_seeds(const unsigned char *const seed[4],
+                  const uint16_t node[4],
+                  unsigned char *const children[4],
+                  const uint32_t num,
+                  const unsigned char salt[HASH_DIGEST_LENGTH]) {
+    const uint32_t csprng_input_len = SALT_LENGTH_BYTES +
+        SEED_LENGTH_BYTES;
+    if (num == 1) {
+        unsigned char csprng_input[csprng_input_len];
+        SHAKE_STATE_STRUCT tree_csprng_state;
+        memcpy(csprng_input, seed[0], SEED_LENGTH_BYTES);
+        memcpy(csprng_input+SEED_LENGTH_BYTES, salt, SALT_LENGTH_BYTES);
+        initialize_csprng_ds(&tree_csprng_state, csprng_input, csprng_input_len, node[0]);
+        csprng_randombytes(children[0],
+                2*SEED_LENGTH_BYTES,
+                &tree_csprng_state);
+        return;
+    }
+
+    /* same input as initialize_csprng_ds, with the domain separation
+     * constant appended in memory order */
+    const uint32_t csprng_x4_input_len = csprng_input_len + sizeof(uint16_t);
+    unsigned char csprng_input[4][csprng_x4_input_len];
+    unsigned char unused_children[2*SEED_LENGTH_BYTES];
+    unsigned char *lane_children[4];
+    SHAKE_X4_STATE_STRUCT tree_csprng_state;
+    for (uint32_t j = 0; j < 4; j++) {
+        const uint32_t lane = j < num ? j : 0;
+        memcpy(csprng_input[j], seed[lane], SEED_LENGTH_BYTES);
+        memcpy(csprng_input[j]+SEED_LENGTH_BYTES, salt, SALT_LENGTH_BYTES);
+        memcpy(csprng_input[j]+csprng_input_len, &node[lane], sizeof(uint16_t));
+        lane_children[j] = j < num ? children[j] : unused_children;
+    }
+    xof_shake128_x4_init(&tree_csprng_state);
+    xof_shake_x4_update(&tree_csprng_state,
+                        csprng_input[0], csprng_input[1],
+                        csprng_input[2], csprng_input[3],
+                        csprng_x4_input_len);
+    xof_shake_x4_final(&tree_csprng_state);
+    xof_shake_x4_extract(&tree_csprng_state,
+                         lane_children[0], lane_children[1],
+                         lane_children[2], lane_children[3],
+                         2*SEED_LENGTH_BYTES);
+}
+
+/* expands num <= 4 nodes of the seed tree in place, see expand_seeds */
+static
+void expand_nodes(unsigned char seed_tree[NUM_NODES_SEED_TREE * SEED_LENGTH_BYTES],
+                  const uint16_t node[4],
+                  const uint16_t left_child[4],
+                  const uint32_t num,
+                  const unsigned char salt[HASH_DIGEST_LENGTH]) {
+    const unsigned char *seed[4];
+    unsigned char *children[4];
+    for (uint32_t j = 0; j < num; j++) {
+        seed[j] = seed_tree + node[j]*SEED_LENGTH_BYTES;
+        children[j] = seed_tree + left_child[j]*SEED_LENGTH_BYTES;
+    }
+    expand_seeds(seed, node, children, num, salt);
+}
+
 /* Seed tree implementation. The binary seed tree is linearized into an array
  * from root to leaves, and from left to right */
 /**
@@ -44,10 +111,49 @@
  *             from roots to leaves layer-by-layer from left to right,
  *             counting from 0 (the integer bound with the root node)"
  *
+ * The nodes of a level are expanded four at a time (see expand_nodes)
  */
 void BuildGGM(unsigned char seed_tree[NUM_NODES_SEED_TREE * SEED_LENGTH_BYTES],
               const unsigned char root_seed[SEED_LENGTH_BYTES],
               const unsigned char salt[HASH_DIGEST_LENGTH]) {
+    /* Set the root seed in the tree from the received parameter */
+    memcpy(seed_tree,root_seed,SEED_LENGTH_BYTES);
+
+    /* off contains the offsets required to move between two layers in order
+     * to compensate for the truncation.
+     * npl contains the number of nodes per level.
+     * lpl contains the number of leaves per level
+     * */
+    const uint16_t off[LOG2(T)+1] = TREE_OFFSETS;
+    const uint16_t npl[LOG2(T)+1] = TREE_NODES_PER_LEVEL;
+    const uint16_t lpl[LOG2(T)+1] = TREE_LEAVES_PER_LEVEL;
+
+    /* Generate the log_2(t) layers from the root, each iteration generates a tree
+     * level; iterate on nodes of the parent level; the leaf nodes on each level
+     * don't need to be expanded, thus only iterate to npl[level]-lpl[level] */
+    int start_node = 0;
+    for (int level = 0; level < LOG2(T); level++){
+        const int num_to_expand = npl[level]-lpl[level];
+        for (int node_in_level = 0; node_in_level < num_to_expand; node_in_level += 4) {
+            const uint32_t num = num_to_expand - node_in_level < 4 ?
+                                 num_to_expand - node_in_level : 4;
+            uint16_t father_node[4] = {0}, left_child_node[4] = {0};
+            for (uint32_t j = 0; j < num; j++) {
+                father_node[j] = start_node + node_in_level + j;
+                left_child_node[j] = LEFT_CHILD(father_node[j]) - off[level];
+            }
+            expand_nodes(seed_tree, father_node, left_child_node, num, salt);
+        }
+        start_node += npl[level];
+    }
+}
+
+/*****************************************************************************/
+
+/* same as BuildGGM, expanding one node at a time */
+void BuildGGM_scalar(unsigned char seed_tree[NUM_NODES_SEED_TREE * SEED_LENGTH_BYTES],
+              const unsigned char root_seed[SEED_LENGTH_BYTES],
+              const unsigned char salt[HASH_DIGEST_LENGTH]) {
     /* input buffer to the CSPRNG, contains the seed to be expanded, a salt,
      * and the integer index of the node being expanded for domain separation */
     const uint32_t csprng_input_len = SALT_LENGTH_BYTES +
@@ -120,8 +226,65 @@ void BuildGGM(unsigned char seed_tree[NUM_NODES_SEED_TREE * SEED_LENGTH_BYTES],
 #define TO_PUBLISH 0
 #define NOT_TO_PUBLISH 1
 
+/* the flags of the nodes are kept one bit per node, in the linearized order
+ * of the tree, set for the nodes NOT_TO_PUBLISH; the last word is padding so
+ * that a range of 64 flags can always be read from two words */
+#define FLAG_WORDS ((NUM_NODES_SEED_TREE+63)/64 + 1)
+
+/* the n <= 64 flags starting from node pos */
+static inline
+uint64_t flag_bits(const uint64_t flags[FLAG_WORDS],
+                   const uint32_t pos,
+                   const uint32_t n) {
+    const uint32_t w = pos / 64, o = pos % 64;
+    uint64_t x = flags[w] >> o;
+    if (o != 0) {
+        x |= flags[w+1] << (64 - o);
+    }
+    return n == 64 ? x : x & (((uint64_t) 1 << n) - 1);
+}
+
+static inline
+void set_flag_bits(uint64_t flags[FLAG_WORDS],
+                   const uint32_t pos,
+                   const uint32_t n,
+                   uint64_t bits) {
+    const uint64_t mask = n == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << n) - 1;
+    const uint32_t w = pos / 64, o = pos % 64;
+    bits &= mask;
+    flags[w] = (flags[w] & ~(mask << o)) | (bits << o);
+    if (o != 0 && o + n > 64) {
+        flags[w+1] = (flags[w+1] & ~(mask >> (64 - o))) | (bits >> (64 - o));
+    }
+}
+
+/* bits 0, 2, 4, ... of x, packed in the low half */
+static inline
+uint64_t even_bits(uint64_t x) {
+    x &= 0x5555555555555555ULL;
+    x = (x | (x >> 1))  & 0x3333333333333333ULL;
+    x = (x | (x >> 2))  & 0x0f0f0f0f0f0f0f0fULL;
+    x = (x | (x >> 4))  & 0x00ff00ff00ff00ffULL;
+    x = (x | (x >> 8))  & 0x0000ffff0000ffffULL;
+    x = (x | (x >> 16)) & 0x00000000ffffffffULL;
+    return x;
+}
+
+/* each bit of x repeated twice, i.e., the flags of the fathers of a run of
+ * nodes starting with a left child, spread over the nodes */
+static inline
+uint64_t double_bits(uint64_t x) {
+    x &= 0x00000000ffffffffULL;
+    x = (x | (x << 16)) & 0x0000ffff0000ffffULL;
+    x = (x | (x << 8))  & 0x00ff00ff00ff00ffULL;
+    x = (x | (x << 4))  & 0x0f0f0f0f0f0f0f0fULL;
+    x = (x | (x << 2))  & 0x3333333333333333ULL;
+    x = (x | (x << 1))  & 0x5555555555555555ULL;
+    return x | (x << 1);
+}
+
 static
-void label_leaves(unsigned char flag_tree[NUM_NODES_SEED_TREE],
+void label_leaves(uint64_t flags[FLAG_WORDS],
                      const unsigned char indices_to_publish[T])
 {
     const uint16_t cons_leaves[TREE_SUBROOTS] = TREE_CONSECUTIVE_LEAVES;
@@ -129,41 +292,47 @@ void label_leaves(unsigned char flag_tree[NUM_NODES_SEED_TREE],
 
     unsigned int cnt = 0;
     for (size_t i=0; i<TREE_SUBROOTS; i++) {
-        for (size_t j=0; j<cons_leaves[i]; j++) {
-            flag_tree[leaves_start_indices[i]+j] = indices_to_publish[cnt];
-            cnt++;
+        for (size_t j=0; j<cons_leaves[i]; j+=64) {
+            const uint32_t n = cons_leaves[i]-j < 64 ? cons_leaves[i]-j : 64;
+            uint64_t bits = 0;
+            for (uint32_t k=0; k<n; k++) {
+                bits |= (uint64_t) (indices_to_publish[cnt+k] != TO_PUBLISH) << k;
+            }
+            set_flag_bits(flags, leaves_start_indices[i]+j, n, bits);
+            cnt += n;
         }
     }
 }
 
+/* the nodes of level >= 1 are laid out in pairs of siblings, starting from a
+ * left child (the first node of the level has an odd index), and the fathers
+ * of consecutive pairs are consecutive: the flag of a father is the OR of the
+ * flags of its children, 64 children at a time */
 static void compute_seeds_to_publish(
-    /* linearized binary tree of boolean nodes containing
-     * flags for each node 1-filled nodes are to be released */
-    unsigned char flags_tree_to_publish[NUM_NODES_SEED_TREE],
+    /* linearized binary tree of flags, one bit per node, set for the nodes
+     * not to be released */
+    uint64_t flags[FLAG_WORDS],
     /* Boolean Array indicating which of the T seeds must be
      * released convention as per the above defines */
     const unsigned char indices_to_publish[T]) {
     /* the indices to publish may be less than the full leaves, copy them
      * into the linearized tree leaves */
-    label_leaves(flags_tree_to_publish, indices_to_publish);
+    label_leaves(flags, indices_to_publish);
 
     const uint16_t off[LOG2(T)+1] = TREE_OFFSETS;
     const uint16_t npl[LOG2(T)+1] = TREE_NODES_PER_LEVEL;
     const uint16_t leaves_start_indices[TREE_SUBROOTS] = TREE_LEAVES_START_INDICES;
 
     /* compute the value for the internal nodes of the tree starting from
-     * the leaves, right to left */
+     * the leaves */
     unsigned int start_node = leaves_start_indices[0];
     for (int level=LOG2(T); level>0; level--) {
-        for (int i=npl[level]-2; i>=0; i-=2) {
-            uint16_t current_node = start_node + i;
-            uint16_t parent_node = PARENT(current_node) + (off[level-1] >> 1);
-            if ((flags_tree_to_publish[current_node] == TO_PUBLISH) &&
-                (flags_tree_to_publish[SIBLING(current_node)] == TO_PUBLISH)){
-                 flags_tree_to_publish[parent_node] = TO_PUBLISH;
-            } else {
-                 flags_tree_to_publish[parent_node] = NOT_TO_PUBLISH;
-            }
+        const uint32_t father_start = PARENT(start_node) + (off[level-1] >> 1);
+        for (uint32_t i=0; i<npl[level]; i+=64) {
+            const uint32_t n = npl[level]-i < 64 ? npl[level]-i : 64;
+            const uint64_t children = flag_bits(flags, start_node+i, n);
+            set_flag_bits(flags, father_start + i/2, n/2,
+                          even_bits(children | (children >> 1)));
         }
         start_node -= npl[level-1];
     }
@@ -179,10 +348,10 @@ uint32_t GGMPath(const unsigned char seed_tree[NUM_NODES_SEED_TREE*SEED_LENGTH_B
                  const unsigned char indices_to_publish[T], // INPUT: binary array denoting which node has to be released (cell == 0) or not
                  unsigned char *seed_storage)             // OUTPUT: sequence of seeds to be released
 {
-    /* complete linearized binary tree containing boolean values determining
+    /* complete linearized binary tree containing the flags determining
      * if a node is to be released or not according to convention above.
      * */
-    unsigned char flags_tree_to_publish[NUM_NODES_SEED_TREE] = {NOT_TO_PUBLISH};
+    uint64_t flags_tree_to_publish[FLAG_WORDS] = {0};
     compute_seeds_to_publish(flags_tree_to_publish, indices_to_publish);
 
     const uint16_t off[LOG2(T)+1] = TREE_OFFSETS;
@@ -193,18 +362,20 @@ uint32_t GGMPath(const unsigned char seed_tree[NUM_NODES_SEED_TREE*SEED_LENGTH_B
     int num_seeds_published = 0;
 
     for (int level = 1; level <= LOG2(T); level++){
-        for (int node_in_level = 0; node_in_level < npl[level]; node_in_level++ ) {
-            uint16_t current_node = start_node + node_in_level;
-            uint16_t father_node = PARENT(current_node) + (off[level-1] >> 1);
-
+        const uint32_t father_start = PARENT(start_node) + (off[level-1] >> 1);
+        for (uint32_t i = 0; i < npl[level]; i += 64) {
+            const uint32_t n = npl[level]-i < 64 ? npl[level]-i : 64;
             /* if seed is to be published and its ancestor/parent node is not,
              * add it to the seed storage */
-            if ( (flags_tree_to_publish[current_node] == TO_PUBLISH) &&
-                 (flags_tree_to_publish[father_node] == NOT_TO_PUBLISH) ) {
+            uint64_t published = ~flag_bits(flags_tree_to_publish, start_node+i, n) &
+                                 double_bits(flag_bits(flags_tree_to_publish, father_start + i/2, n/2));
+            while (published != 0) {
+                const uint16_t current_node = start_node + i + __builtin_ctzll(published);
                 memcpy(seed_storage + num_seeds_published*SEED_LENGTH_BYTES,
                         seed_tree + current_node*SEED_LENGTH_BYTES,
                         SEED_LENGTH_BYTES);
                 num_seeds_published++;
+                published &= published - 1;
             }
         }
         start_node += npl[level];
@@ -220,63 +391,62 @@ uint32_t RebuildGGM(unsigned char seed_tree[NUM_NODES_SEED_TREE*SEED_LENGTH_BYTE
                     const unsigned char indices_to_publish[T],
                     const unsigned char *stored_seeds,
                     const unsigned char salt[HASH_DIGEST_LENGTH]) {
-   /* complete linearized binary tree containing boolean values determining
+   /* complete linearized binary tree containing the flags determining
      * if a node is to be released or not according to aboves convention
      */
-    unsigned char flags_tree_to_publish[NUM_NODES_SEED_TREE] = {0};
+    uint64_t flags_tree_to_publish[FLAG_WORDS] = {0};
     compute_seeds_to_publish(flags_tree_to_publish, indices_to_publish);
 
-    const uint32_t csprng_input_len = SALT_LENGTH_BYTES +
-        SEED_LENGTH_BYTES;
-    unsigned char csprng_input[csprng_input_len];
-    SHAKE_STATE_STRUCT tree_csprng_state;
-
     const uint16_t off[LOG2(T)+1] = TREE_OFFSETS;
     const uint16_t npl[LOG2(T)+1] = TREE_NODES_PER_LEVEL;
     const uint16_t lpl[LOG2(T)+1] = TREE_LEAVES_PER_LEVEL;
 
-    memcpy(csprng_input + SEED_LENGTH_BYTES, salt, SALT_LENGTH_BYTES);
-
     /* regenerating the seed tree never starts from the root, as it is never
      * disclosed */
     int nodes_used = 0;
     int start_node = 1;
     for (int level = 1; level <= LOG2(T); level++){
-        for (int node_in_level = 0; node_in_level < npl[level]; node_in_level++ ) {
-            uint16_t current_node = start_node + node_in_level;
-            uint16_t father_node = PARENT(current_node) + (off[level-1] >> 1);
-            uint16_t left_child = LEFT_CHILD(current_node) - off[level];
-
-            /* if the current node is a seed which was published (thus its father
-             * was not), memcpy it in place */
-            if ( flags_tree_to_publish[current_node] == TO_PUBLISH ) {
-                if ( flags_tree_to_publish[father_node] == NOT_TO_PUBLISH ) {
+        const uint32_t father_start = PARENT(start_node) + (off[level-1] >> 1);
+        /* the published nodes of the level which are not leaves are expanded
+         * four at a time, once their seeds are in place */
+        uint16_t expand_node[4] = {0}, left_child[4] = {0};
+        uint32_t num_to_expand = 0;
+        for (uint32_t i = 0; i < npl[level]; i += 64) {
+            const uint32_t n = npl[level]-i < 64 ? npl[level]-i : 64;
+            const uint64_t fathers = double_bits(flag_bits(flags_tree_to_publish, father_start + i/2, n/2));
+            uint64_t to_publish = ~flag_bits(flags_tree_to_publish, start_node+i, n) &
+                                  (n == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << n) - 1);
+            while (to_publish != 0) {
+                const uint32_t node_in_level = i + __builtin_ctzll(to_publish);
+                const uint16_t current_node = start_node + node_in_level;
+
+                /* if the current node is a seed which was published (thus its
+                 * father was not), memcpy it in place */
+                if ((fathers >> (node_in_level - i)) & 1) {
                     memcpy(seed_tree + current_node*SEED_LENGTH_BYTES,
                             stored_seeds + nodes_used*SEED_LENGTH_BYTES,
                             SEED_LENGTH_BYTES );
                     nodes_used++;
                 }
-            }
 
-            /* If the current node is published and not a leaf, CSPRNG-expand its children.
-             * Since there is no reason of expanding leaves, only iterate to nodes per level (npl)
-             * minus leaves per level (lpl) in each level */
-            if ( ( flags_tree_to_publish[current_node] == TO_PUBLISH ) && (node_in_level < npl[level]-lpl[level] ) ) {
-                /* prepare the CSPRNG input to expand the children of node current_node */
-                memcpy(csprng_input,
-                        seed_tree + current_node*SEED_LENGTH_BYTES,
-                        SEED_LENGTH_BYTES);
-
-                /* Domain separation using father node index */
-                uint16_t domain_sep = current_node;
-
-                /* expand the children (stored contiguously), by construction always two children */
-                initialize_csprng_ds(&tree_csprng_state, csprng_input, csprng_input_len, domain_sep);
-                csprng_randombytes(seed_tree + left_child*SEED_LENGTH_BYTES,
-                        2*SEED_LENGTH_BYTES,
-                        &tree_csprng_state);
+                /* Since there is no reason of expanding leaves, only expand
+                 * the nodes before the leaves of the level, i.e., the first
+                 * npl[level]-lpl[level] ones */
+                if (node_in_level < (uint32_t) (npl[level]-lpl[level])) {
+                    expand_node[num_to_expand] = current_node;
+                    left_child[num_to_expand] = LEFT_CHILD(current_node) - off[level];
+                    num_to_expand++;
+                    if (num_to_expand == 4) {
+                        expand_nodes(seed_tree, expand_node, left_child, 4, salt);
+                        num_to_expand = 0;
+                    }
+                }
+                to_publish &= to_publish - 1;
             }
         }
+        if (num_to_expand > 0) {
+            expand_nodes(seed_tree, expand_node, left_child, num_to_expand, salt);
+        }
         start_node += npl[level];
     }
 
@@ -301,3 +471,151 @@ void seed_leaves(unsigned char rounds_seeds[T*SEED_LENGTH_BYTES],
         }
     }
 }
+
+const unsigned char *seed_leaf(const unsigned char seed_tree[NUM_NODES_SEED_TREE*SEED_LENGTH_BYTES],
+                               uint32_t i)
+{
+    const uint16_t cons_leaves[TREE_SUBROOTS] = TREE_CONSECUTIVE_LEAVES;
+    const uint16_t leaves_start_indices[TREE_SUBROOTS] = TREE_LEAVES_START_INDICES;
+
+    size_t subroot = 0;
+    while (i >= cons_leaves[subroot]) {
+        i -= cons_leaves[subroot];
+        subroot++;
+    }
+    return seed_tree + (leaves_start_indices[subroot]+i)*SEED_LENGTH_BYTES;
+}
+
+/*****************************************************************************/
+
+static
+void ggm_walk_init(ggm_walk_t *walk,
+                   const unsigned char root_seed[SEED_LENGTH_BYTES],
+                   const unsigned char salt[HASH_DIGEST_LENGTH],
+                   const uint64_t *flags) {
+    const uint16_t npl[LOG2(T)+1] = TREE_NODES_PER_LEVEL;
+    const uint16_t lpl[LOG2(T)+1] = TREE_LEAVES_PER_LEVEL;
+    uint16_t start_node = 0;
+    for (int level = 0; level <= LOG2(T); level++) {
+        walk->first_leaf[level] = start_node + npl[level] - lpl[level];
+        start_node += npl[level];
+    }
+    memcpy(walk->salt, salt, HASH_DIGEST_LENGTH);
+    walk->flags = flags;
+    walk->stack[0].node = 0;
+    walk->stack[0].level = 0;
+    memcpy(walk->stack[0].seed, root_seed, SEED_LENGTH_BYTES);
+    walk->num_nodes = 1;
+}
+
+/* the walk stops on the leaves and, if it has flags, on the nodes to
+ * publish */
+static inline
+int ggm_walk_stops_on(const ggm_walk_t *walk, const ggm_node_t *n) {
+    return n->node >= walk->first_leaf[n->level] ||
+           (walk->flags != NULL && flag_bits(walk->flags, n->node, 1) == TO_PUBLISH);
+}
+
+/* the stack holds a left to right cut of the tree, the leftmost node on top.
+ * A node the walk stops on is returned once on top; otherwise, the (up to
+ * four) topmost nodes it does not stop on are expanded together, and
+ * replaced by their children
+ * \return 0 once the walk is over */
+static
+uint32_t ggm_walk_next(ggm_walk_t *walk, ggm_node_t *out) {
+    const uint16_t off[LOG2(T)+1] = TREE_OFFSETS;
+    while (walk->num_nodes > 0) {
+        if (ggm_walk_stops_on(walk, &walk->stack[walk->num_nodes-1])) {
+            walk->num_nodes--;
+            *out = walk->stack[walk->num_nodes];
+            return 1;
+        }
+
+        ggm_node_t parents[4];
+        uint32_t num = 0;
+        while (num < 4 && num < walk->num_nodes &&
+               !ggm_walk_stops_on(walk, &walk->stack[walk->num_nodes-1-num])) {
+            parents[num] = walk->stack[walk->num_nodes-1-num];
+            num++;
+        }
+        walk->num_nodes -= num;
+
+        unsigned char children[4][2*SEED_LENGTH_BYTES];
+        const unsigned char *seed[4];
+        uint16_t node[4];
+        unsigned char *children_ptr[4];
+        for (uint32_t j = 0; j < num; j++) {
+            seed[j] = parents[j].seed;
+            node[j] = parents[j].node;
+            children_ptr[j] = children[j];
+        }
+        expand_seeds(seed, node, children_ptr, num, walk->salt);
+
+        for (uint32_t j = num; j-- > 0; ) {
+            const uint16_t left_child = LEFT_CHILD(parents[j].node) - off[parents[j].level];
+            for (uint32_t c = 2; c-- > 0; ) {
+                ggm_node_t *child = &walk->stack[walk->num_nodes++];
+                child->node = left_child + c;
+                child->level = parents[j].level + 1;
+                memcpy(child->seed, children[j] + c*SEED_LENGTH_BYTES, SEED_LENGTH_BYTES);
+            }
+        }
+    }
+    return 0;
+}
+
+void GGMLeavesInit(ggm_walk_t *walk,
+                   const unsigned char root_seed[SEED_LENGTH_BYTES],
+                   const unsigned char salt[HASH_DIGEST_LENGTH]) {
+    ggm_walk_init(walk, root_seed, salt, NULL);
+}
+
+uint32_t GGMLeavesNext(ggm_walk_t *walk,
+                       unsigned char leaves[4][SEED_LENGTH_BYTES]) {
+    uint32_t num_leaves = 0;
+    ggm_node_t leaf;
+    while (num_leaves < 4 && ggm_walk_next(walk, &leaf)) {
+        memcpy(leaves[num_leaves], leaf.seed, SEED_LENGTH_BYTES);
+        num_leaves++;
+    }
+    return num_leaves;
+}
+
+uint32_t GGMPathFromRoot(const unsigned char root_seed[SEED_LENGTH_BYTES],
+                         const unsigned char salt[HASH_DIGEST_LENGTH],
+                         const unsigned char indices_to_publish[T],
+                         unsigned char *seed_storage,
+                         unsigned char *unpublished_leaves) {
+    uint64_t flags_tree_to_publish[FLAG_WORDS] = {0};
+    compute_seeds_to_publish(flags_tree_to_publish, indices_to_publish);
+
+    ggm_walk_t walk;
+    ggm_walk_init(&walk, root_seed, salt, flags_tree_to_publish);
+
+    /* the walk meets the published nodes left to right, they are stored
+     * level by level as GGMPath does */
+    uint16_t published_nodes[MAX_PUBLISHED_SEEDS];
+    uint32_t num_seeds_published = 0;
+    uint32_t num_unpublished_leaves = 0;
+    ggm_node_t n;
+    while (ggm_walk_next(&walk, &n)) {
+        if (flag_bits(flags_tree_to_publish, n.node, 1) == NOT_TO_PUBLISH) {
+            memcpy(unpublished_leaves + num_unpublished_leaves*SEED_LENGTH_BYTES,
+                   n.seed, SEED_LENGTH_BYTES);
+            num_unpublished_leaves++;
+        } else if (n.node != 0) {
+            uint32_t i = num_seeds_published;
+            while (i > 0 && published_nodes[i-1] > n.node) {
+                published_nodes[i] = published_nodes[i-1];
+                memcpy(seed_storage + i*SEED_LENGTH_BYTES,
+                       seed_storage + (i-1)*SEED_LENGTH_BYTES,
+                       SEED_LENGTH_BYTES);
+                i--;
+            }
+            published_nodes[i] = n.node;
+            memcpy(seed_storage + i*SEED_LENGTH_BYTES, n.seed, SEED_LENGTH_BYTES);
+            num_seeds_published++;
+        }
+    }
+    return num_seeds_published;
+}
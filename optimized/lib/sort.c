@@ -22,6 +22,7 @@
 #include "utils.h"
 #include "fq_arith.h"
 #include "codes.h"
+#include "align.h"
 
 #define MIN(X, Y) (((X) < (Y)) ? (X) : (Y))
 
@@ -133,7 +134,7 @@ void counting_sort(FQ_ELEM *arr,
 	}
 }
 
-void histogram(FQ_ELEM *mset,
+void histogram_scalar(FQ_ELEM *mset,
                 const FQ_ELEM *to_order,
                 const uint32_t size) {
 
@@ -143,7 +144,7 @@ void histogram(FQ_ELEM *mset,
 	}
 }
 
-void histogram_c1_c2(FQ_ELEM *mset,
+void histogram_c1_c2_scalar(FQ_ELEM *mset,
                 const FQ_ELEM *c1,
                 const FQ_ELEM *c2,
                 const uint32_t size) {
@@ -154,3 +155,96 @@ void histogram_c1_c2(FQ_ELEM *mset,
 		mset[c2[i]]++;
 	}
 }
+
+/* The histograms below are split in HISTOGRAM_WAYS sub-histograms counting
+ * interleaved elements: consecutive increments hit different tables, so
+ * that an increment does not wait for the store of the previous one when
+ * they hit the same bin. The sub-histograms are summed with vector adds;
+ * no bin overflows as long as size < 256 */
+#define HISTOGRAM_WAYS 4
+#define HISTOGRAM_BINS NEXT_MULTIPLE(Q, 32)
+
+/// clears the sub-histograms
+static inline
+void histogram_ways_clear(uint8_t ways[HISTOGRAM_WAYS][HISTOGRAM_BINS]) {
+#ifdef USE_AVX2
+    vec256_t zero;
+    vset8(zero, 0);
+    for (uint32_t w = 0; w < HISTOGRAM_WAYS; w++) {
+        for (uint32_t i = 0; i < HISTOGRAM_BINS; i += 32) {
+            vstore256((vec256_t *)(ways[w] + i), zero);
+        }
+    }
+#else
+    memset(ways, 0, HISTOGRAM_WAYS*HISTOGRAM_BINS);
+#endif
+}
+
+/// sums the sub-histograms into the Q bins of mset
+static inline
+void histogram_ways_merge(FQ_ELEM *mset,
+                          uint8_t ways[HISTOGRAM_WAYS][HISTOGRAM_BINS]) {
+#ifdef USE_AVX2
+    vec256_t a, b;
+    for (uint32_t i = 0; i < HISTOGRAM_BINS; i += 32) {
+        vload256(a, (vec256_t *)(ways[0] + i));
+        for (uint32_t w = 1; w < HISTOGRAM_WAYS; w++) {
+            vload256(b, (vec256_t *)(ways[w] + i));
+            vadd8(a, a, b);
+        }
+        vstore256((vec256_t *)(ways[0] + i), a);
+    }
+#else
+    for (uint32_t w = 1; w < HISTOGRAM_WAYS; w++) {
+        for (uint32_t i = 0; i < Q; i++) {
+            ways[0][i] += ways[w][i];
+        }
+    }
+#endif
+    memcpy(mset, ways[0], sizeof(FQ_ELEM)*Q);
+}
+
+/// NOTE: size must be less than 256
+/// \param mset[out]: number of occurrences of each element of Fq
+/// \param to_order[in]: elements to count, reduced mod 127
+void histogram(FQ_ELEM *mset,
+                const FQ_ELEM *to_order,
+                const uint32_t size) {
+    ALIGN(32) uint8_t ways[HISTOGRAM_WAYS][HISTOGRAM_BINS];
+    histogram_ways_clear(ways);
+
+    uint32_t i = 0;
+    for (; i + HISTOGRAM_WAYS <= size; i += HISTOGRAM_WAYS) {
+        ways[0][to_order[i]]++;
+        ways[1][to_order[i+1]]++;
+        ways[2][to_order[i+2]]++;
+        ways[3][to_order[i+3]]++;
+    }
+    for (; i < size; i++) {
+        ways[0][to_order[i]]++;
+    }
+    histogram_ways_merge(mset, ways);
+}
+
+/// same as histogram on the concatenation c1 || c2
+/// NOTE: 2*size must be less than 256
+void histogram_c1_c2(FQ_ELEM *mset,
+                const FQ_ELEM *c1,
+                const FQ_ELEM *c2,
+                const uint32_t size) {
+    ALIGN(32) uint8_t ways[HISTOGRAM_WAYS][HISTOGRAM_BINS];
+    histogram_ways_clear(ways);
+
+    uint32_t i = 0;
+    for (; i + 2 <= size; i += 2) {
+        ways[0][c1[i]]++;
+        ways[1][c2[i]]++;
+        ways[2][c1[i+1]]++;
+        ways[3][c2[i+1]]++;
+    }
+    for (; i < size; i++) {
+        ways[0][c1[i]]++;
+        ways[1][c2[i]]++;
+    }
+    histogram_ways_merge(mset, ways);
+}
@@ -0,0 +1,126 @@
+/**
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ''AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **/
+
+/* registry of the parameter sets linked in the library. The list of the
+ * targets is generated by CMake (include/speck_params_list.h.in). This
+ * translation unit runs before the CPU is known to support AVX2: it must be
+ * compiled with the flags of the portable backend */
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "speck_params.h"
+#include "speck_params_list.h"
+#include "cpu_features.h"
+
+/* handles of the instances, as renamed by cmake/namespace_backend.cmake */
+#define PARAMS_DECLARE(t)                                                      \
+   extern const speck_params_t speck_t##t##_portable_SPECK_params_instance;    \
+   extern const speck_params_t speck_t##t##_avx2_SPECK_params_instance;
+#define PARAMS_PORTABLE_ENTRY(t) &speck_t##t##_portable_SPECK_params_instance,
+#define PARAMS_AVX2_ENTRY(t) &speck_t##t##_avx2_SPECK_params_instance,
+#define PARAMS_COUNT(t) + 1
+
+SPECK_PARAMS_LIST(PARAMS_DECLARE)
+
+#define NUM_PARAMS (0 SPECK_PARAMS_LIST(PARAMS_COUNT))
+
+enum {
+   PARAMS_BACKEND_PORTABLE = 0,
+   PARAMS_BACKEND_AVX2 = 1,
+   PARAMS_NUM_BACKENDS
+};
+
+static const char *const backend_names[PARAMS_NUM_BACKENDS] = {
+   [PARAMS_BACKEND_PORTABLE] = "portable",
+   [PARAMS_BACKEND_AVX2] = "avx2",
+};
+
+static const speck_params_t *const params[PARAMS_NUM_BACKENDS][NUM_PARAMS] = {
+   [PARAMS_BACKEND_PORTABLE] = { SPECK_PARAMS_LIST(PARAMS_PORTABLE_ENTRY) },
+   [PARAMS_BACKEND_AVX2] = { SPECK_PARAMS_LIST(PARAMS_AVX2_ENTRY) },
+};
+
+static pthread_once_t backend_once = PTHREAD_ONCE_INIT;
+static int selected_backend = PARAMS_BACKEND_PORTABLE;
+
+/// \return: 1 if the host executes the instances of the backend
+static
+int backend_supported(int backend) {
+   return backend == PARAMS_BACKEND_PORTABLE ||
+          (backend == PARAMS_BACKEND_AVX2 && cpu_supports_avx2());
+}
+
+/// \return: index of the backend with the given name, -1 if none
+static
+int backend_index(const char *name) {
+   for (int b = 0; b < PARAMS_NUM_BACKENDS; b++) {
+      if (strcmp(name, backend_names[b]) == 0) {
+         return b;
+      }
+   }
+   return -1;
+}
+
+/// same choice as the one of lib/dispatch.c
+static
+void backend_resolve(void) {
+   const char *forced = getenv("SPECK_BACKEND");
+   if (forced != NULL) {
+      const int b = backend_index(forced);
+      selected_backend = (b >= 0 && backend_supported(b)) ? b : PARAMS_BACKEND_PORTABLE;
+      return;
+   }
+   selected_backend = backend_supported(PARAMS_BACKEND_AVX2) ? PARAMS_BACKEND_AVX2
+                                                             : PARAMS_BACKEND_PORTABLE;
+} /* end backend_resolve */
+
+static inline
+const speck_params_t *const *selected(void) {
+   pthread_once(&backend_once, backend_resolve);
+   return params[selected_backend];
+}
+
+/// \return: the handle with t rounds among the ones of a backend, NULL if
+///          there is none
+static
+const speck_params_t *params_find(const speck_params_t *const backend_params[NUM_PARAMS],
+                                  uint32_t t) {
+   for (uint32_t i = 0; i < NUM_PARAMS; i++) {
+      if (backend_params[i]->t == t) {
+         return backend_params[i];
+      }
+   }
+   return NULL;
+}
+
+uint32_t SPECK_num_params(void) {
+   return NUM_PARAMS;
+}
+
+const speck_params_t *SPECK_params_at(uint32_t i) {
+   return (i < NUM_PARAMS) ? selected()[i] : NULL;
+}
+
+const speck_params_t *SPECK_params(uint32_t t) {
+   return params_find(selected(), t);
+}
+
+const speck_params_t *SPECK_params_backend(uint32_t t,
+                                           const char *backend) {
+   const int b = backend_index(backend);
+   return (b >= 0 && backend_supported(b)) ? params_find(params[b], t) : NULL;
+}
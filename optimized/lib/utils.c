@@ -28,6 +28,15 @@
 #include <stdlib.h>
 
 
+/* memset is called through a volatile pointer, which the compiler cannot
+ * assume to point to it, so that the store is not removed as dead */
+static void *(*const volatile wipe_memset)(void *, int, size_t) = memset;
+
+void wipe(void *p,
+          const size_t len) {
+    wipe_memset(p, 0, len);
+}
+
 /// swaps a and b if
 void cswap(uintptr_t *a,
            uintptr_t *b,
@@ -99,21 +108,16 @@ int verify(const uint8_t *a,
 #endif
 
 #define MAX_KEYPAIR_INDEX (NUM_KEYPAIRS-1)
-#define KEYPAIR_INDEX_MASK ( ((uint16_t)1 << BITS_TO_REPRESENT(MAX_KEYPAIR_INDEX)) -1 )
-/* bitmask for rejection sampling of the position */
-#define  POSITION_MASK (( (uint16_t)1 << BITS_TO_REPRESENT(T-1))-1)
 
 /* Expands a digest expanding it into a fixed weight string with elements in
  * Z_{NUM_KEYPAIRS}. */
 void SampleChallenge(uint8_t fixed_weight_string[T],
                      const uint8_t digest[HASH_DIGEST_LENGTH]) {
-    SHAKE_STATE_STRUCT shake_state;
-    initialize_csprng(&shake_state,
-                      (const unsigned char *) digest,
-                      HASH_DIGEST_LENGTH);
+    csprng_reader_t shake_reader;
+    csprng_reader_init(&shake_reader,
+                       (const unsigned char *) digest,
+                       HASH_DIGEST_LENGTH);
 
-    uint64_t rnd_buf;
-    uint32_t c = 0;
     for (uint32_t i = 0; i < T-W; i++) {
         fixed_weight_string[i] = 0;
     }
@@ -122,16 +126,8 @@ void SampleChallenge(uint8_t fixed_weight_string[T],
         for (uint32_t i = T-W; i < T; i++) {
             uint8_t value;
             do {
-                if (c == 0) {
-                    csprng_randombytes((unsigned char *) &rnd_buf,
-                                     sizeof(uint64_t),
-                                     &shake_state);
-                    c = 64u / BITS_TO_REPRESENT(MAX_KEYPAIR_INDEX);
-                }
-
-                value = rnd_buf & (KEYPAIR_INDEX_MASK);
-                rnd_buf >>= BITS_TO_REPRESENT(MAX_KEYPAIR_INDEX);
-                c -= 1;
+                value = csprng_reader_next_bits(&shake_reader,
+                                                BITS_TO_REPRESENT(MAX_KEYPAIR_INDEX));
             } while (value >= (NUM_KEYPAIRS-1));
             fixed_weight_string[i] = value + 1;
         }
@@ -144,15 +140,7 @@ void SampleChallenge(uint8_t fixed_weight_string[T],
     for (uint32_t p = T - W; p < T; p++) {
         POSITION_T pos;
         do {
-            if (c == 0) {
-                csprng_randombytes((unsigned char *) &rnd_buf,
-                                   sizeof(uint64_t),
-                                   &shake_state);
-                c = 64u / BITS_TO_REPRESENT(T-1);
-            }
-            pos = rnd_buf & (POSITION_MASK);
-            rnd_buf >>= BITS_TO_REPRESENT(T-1);
-            c -= 1;
+            pos = csprng_reader_next_bits(&shake_reader, BITS_TO_REPRESENT(T-1));
         } while (pos > p);
         const uint8_t tmp = fixed_weight_string[p];
         fixed_weight_string[p] = fixed_weight_string[pos];
@@ -0,0 +1,112 @@
+/**
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ''AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **/
+#include <pthread.h>
+#include <stddef.h>
+
+#include "worker_pool.h"
+
+/* the pending tasks are kept in a FIFO queue; the lock also guards the
+ * completion flags of the tasks, on which the callers wait */
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t task_queued = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t task_done = PTHREAD_COND_INITIALIZER;
+static worker_task_t *queue_head = NULL;
+static worker_task_t *queue_tail = NULL;
+static uint32_t num_workers = 0;
+
+/// NOTE: to be called with pool_lock held
+/// \return: the oldest pending task, NULL if none
+static
+worker_task_t *queue_pop(void) {
+    worker_task_t *task = queue_head;
+    if (task != NULL) {
+        queue_head = task->next;
+        if (queue_head == NULL) {
+            queue_tail = NULL;
+        }
+    }
+    return task;
+}
+
+/// NOTE: to be called with pool_lock held, which is released while the
+/// task runs
+static
+void task_complete(worker_task_t *task) {
+    pthread_mutex_unlock(&pool_lock);
+    task->run(task->arg);
+    pthread_mutex_lock(&pool_lock);
+    task->done = 1;
+    pthread_cond_broadcast(&task_done);
+}
+
+static
+void *worker_main(void *arg) {
+    (void) arg;
+    pthread_mutex_lock(&pool_lock);
+    for (;;) {
+        worker_task_t *task = queue_pop();
+        if (task == NULL) {
+            pthread_cond_wait(&task_queued, &pool_lock);
+        } else {
+            task_complete(task);
+        }
+    }
+    return NULL;
+}
+
+/// \param tasks[in/out]: tasks to run, the first one on the calling thread
+/// \param num_tasks[in]: number of tasks
+void worker_pool_run(worker_task_t tasks[],
+                     uint32_t num_tasks) {
+    pthread_mutex_lock(&pool_lock);
+    /* best effort: the threads which fail to start are replaced by the
+     * calling one */
+    while (num_workers + 1 < num_tasks) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, worker_main, NULL) != 0) {
+            break;
+        }
+        pthread_detach(thread);
+        num_workers++;
+    }
+    for (uint32_t i = 1; i < num_tasks; i++) {
+        tasks[i].next = NULL;
+        tasks[i].done = 0;
+        if (queue_tail == NULL) {
+            queue_head = &tasks[i];
+        } else {
+            queue_tail->next = &tasks[i];
+        }
+        queue_tail = &tasks[i];
+        pthread_cond_signal(&task_queued);
+    }
+    pthread_mutex_unlock(&pool_lock);
+
+    tasks[0].run(tasks[0].arg);
+
+    pthread_mutex_lock(&pool_lock);
+    for (uint32_t i = 1; i < num_tasks; i++) {
+        while (!tasks[i].done) {
+            worker_task_t *task = queue_pop();
+            if (task == NULL) {
+                pthread_cond_wait(&task_done, &pool_lock);
+            } else {
+                task_complete(task);
+            }
+        }
+    }
+    pthread_mutex_unlock(&pool_lock);
+} /* end worker_pool_run */
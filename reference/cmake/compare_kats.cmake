@@ -0,0 +1,24 @@
+# compares the KATS files generated by two builds of the scheme
+#
+# cmake -DEXPECTED=kat/133 -DACTUAL=kat_vec/133 -P compare_kats.cmake
+
+foreach(var EXPECTED ACTUAL)
+    if(NOT DEFINED ${var})
+        message(FATAL_ERROR "compare_kats: ${var} is not set")
+    endif()
+endforeach()
+
+file(GLOB kats RELATIVE ${EXPECTED} ${EXPECTED}/PQCsignKAT_*.rsp)
+if(NOT kats)
+    message(FATAL_ERROR "compare_kats: no KATS in ${EXPECTED}")
+endif()
+
+foreach(kat ${kats})
+    execute_process(COMMAND ${CMAKE_COMMAND} -E compare_files
+                            ${EXPECTED}/${kat} ${ACTUAL}/${kat}
+                    RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "compare_kats: ${ACTUAL}/${kat} differs from ${EXPECTED}/${kat}")
+    endif()
+    message(STATUS "${kat}: identical")
+endforeach()
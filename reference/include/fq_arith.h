@@ -18,6 +18,7 @@
 
 #include "parameters.h"
 #include "rng.h"
+#include "fq_vec.h"
 
 #define NUM_BITS_Q (BITS_TO_REPRESENT(Q))
 
@@ -238,9 +239,21 @@ FQ_ELEM row_acc_inv(const FQ_ELEM *d) {
 /// /param s
 static inline
 void row_mul(FQ_ELEM *row, const FQ_ELEM s) {
+#ifdef USE_VECTOR_EXT
+    const fq_vec_wide_t sv = fq_vec_splat(s);
+    uint32_t col = 0;
+    for (; col + FQ_VEC_LANES <= K; col += FQ_VEC_LANES) {
+        fq_vec_store(row + col, fq_vec_mul(fq_vec_load(row + col), sv));
+    }
+    if (col < K) {
+        const fq_vec_t t = fq_vec_load_partial(row + col, K - col);
+        fq_vec_store_partial(row + col, fq_vec_mul(t, sv), K - col);
+    }
+#else
     for (uint32_t col = 0; col < (K); col++) {
         row[col] = fq_mul(s, row[col]);
     }
+#endif
 }
 
 /// scalar multiplication of a row
@@ -270,10 +283,49 @@ void row_mul3(FQ_ELEM *out, const FQ_ELEM *in1, const FQ_ELEM *in2) {
 /// \param s
 static inline
 void row_sum(FQ_ELEM *out, const FQ_ELEM *in, const FQ_ELEM s, uint8_t c) {
+#ifdef USE_VECTOR_EXT
+    const fq_vec_wide_t sv = fq_vec_splat(s);
+    uint32_t i = 0;
+    for (; i + FQ_VEC_LANES <= c; i += FQ_VEC_LANES) {
+        const fq_vec_t t = fq_vec_load(out + i) + fq_vec_mul(fq_vec_load(in + i), sv);
+        fq_vec_store(out + i, fq_vec_red(t));
+    }
+    if (i < c) {
+        const fq_vec_t t = fq_vec_load_partial(out + i, c - i) +
+                           fq_vec_mul(fq_vec_load_partial(in + i, c - i), sv);
+        fq_vec_store_partial(out + i, fq_vec_red(t), c - i);
+    }
+#else
     for(uint8_t i = 0; i<c; i++){
         out[i] = fq_add(out[i],fq_mul(in[i],s));
     }
+#endif
+}
+
+#ifdef USE_VECTOR_EXT
+/// sum(in1[i]*in2[i] for i in range(N-K)): the lazy products are
+/// accumulated per lane, (N-K)/FQ_VEC_LANES + 1 of them fit in 16 bits
+static inline
+FQ_ELEM fq_vec_dot(const FQ_ELEM *in1, const FQ_ELEM *in2) {
+    fq_vec_wide_t acc = {0};
+    uint32_t col = 0;
+    for (; col + FQ_VEC_LANES <= (N-K); col += FQ_VEC_LANES) {
+        acc += fq_vec_fold(fq_vec_widen(fq_vec_load(in1 + col)) *
+                           fq_vec_widen(fq_vec_load(in2 + col)));
+    }
+    if (col < (N-K)) {
+        acc += fq_vec_fold(fq_vec_widen(fq_vec_load_partial(in1 + col, (N-K) - col)) *
+                           fq_vec_widen(fq_vec_load_partial(in2 + col, (N-K) - col)));
+    }
+    const fq_vec_t t = fq_vec_red_wide(acc);
+
+    FQ_DOUBLEPREC s = 0;
+    for (uint32_t i = 0; i < FQ_VEC_LANES; i++) {
+        s += t[i];
+    }
+    return fq_red(s);
 }
+#endif
 
 /// Inner product of a row
 /// \param out = sum(in[i]*in[i] for i in range(K))
@@ -281,10 +333,14 @@ void row_sum(FQ_ELEM *out, const FQ_ELEM *in, const FQ_ELEM s, uint8_t c) {
 /// \param s
 static inline
 void inner_prod(FQ_ELEM *out, const FQ_ELEM *in) {
+#ifdef USE_VECTOR_EXT
+    *out = fq_vec_dot(in, in);
+#else
     *out = 0;
     for (uint32_t col = 0; col < (N-K); col++) {
         *out = fq_add(*out,fq_mul(in[col], in[col]));
     }
+#endif
 }
 
 /// Scalar product of two row
@@ -293,10 +349,14 @@ void inner_prod(FQ_ELEM *out, const FQ_ELEM *in) {
 /// \param s
 static inline
 void scalar_prod(FQ_ELEM *out, const FQ_ELEM *in1, const FQ_ELEM *in2) {
+#ifdef USE_VECTOR_EXT
+    *out = fq_vec_dot(in1, in2);
+#else
     *out = 0;
     for (uint32_t col = 0; col < (N-K); col++) {
         *out = fq_add(*out,fq_mul(in1[col], in2[col]));
     }
+#endif
 }
 
 /// invert a row
@@ -0,0 +1,119 @@
+/**
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHORS ''AS IS'' AND ANY EXPRESS
+ * OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHORS OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR
+ * BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ * WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+ * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ * EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ **/
+
+#pragma once
+
+#include <string.h>
+#include "parameters.h"
+
+/* Arithmetic on lanes of Fq elements, written with the GCC/Clang vector
+ * extensions, so that the compiler lowers it to whatever SIMD the target
+ * has (AVX2, SSE2, NEON, ...). The reduction mirrors barrett_mul_u16 and
+ * W_RED127_ of the optimized implementation (include/macro.h): as
+ * q = 2^7 - 1, folding the bits above the 7th onto the low ones preserves
+ * the residue. Products are computed in 16-bit lanes and folded back to
+ * bytes right away, additions and reductions run on 8-bit lanes. Every
+ * kernel returns canonical elements, so the results are bit-identical to
+ * the scalar ones */
+#ifdef USE_VECTOR_EXT
+
+#define FQ_VEC_LANES 16
+
+/* FQ_VEC_LANES elements, and the same lanes widened to 16 bits */
+typedef uint8_t fq_vec_t __attribute__((vector_size(FQ_VEC_LANES)));
+typedef uint16_t fq_vec_wide_t __attribute__((vector_size(2*FQ_VEC_LANES)));
+
+static inline
+fq_vec_t fq_vec_load(const FQ_ELEM *in) {
+    fq_vec_t a;
+    memcpy(&a, in, FQ_VEC_LANES);
+    return a;
+}
+
+static inline
+void fq_vec_store(FQ_ELEM *out, const fq_vec_t a) {
+    memcpy(out, &a, FQ_VEC_LANES);
+}
+
+/// loads len < FQ_VEC_LANES elements, the remaining lanes are zero
+static inline
+fq_vec_t fq_vec_load_partial(const FQ_ELEM *in, const uint32_t len) {
+    fq_vec_t a = {0};
+    memcpy(&a, in, len);
+    return a;
+}
+
+/// stores the first len < FQ_VEC_LANES lanes of a
+static inline
+void fq_vec_store_partial(FQ_ELEM *out, const fq_vec_t a, const uint32_t len) {
+    memcpy(out, &a, len);
+}
+
+static inline
+fq_vec_wide_t fq_vec_widen(const fq_vec_t a) {
+    return __builtin_convertvector(a, fq_vec_wide_t);
+}
+
+/// partial reduction: (a & q) + (a >> 7) keeps a mod q, and brings
+/// a < 2^16 to at most 638
+static inline
+fq_vec_wide_t fq_vec_fold(const fq_vec_wide_t a) {
+    return (a & Q) + (a >> 7);
+}
+
+/// the same partial reduction, to bytes: at most 253 for a < 127*128
+static inline
+fq_vec_t fq_vec_fold_narrow(const fq_vec_wide_t a) {
+    return __builtin_convertvector(a & Q, fq_vec_t) +
+           __builtin_convertvector(a >> 7, fq_vec_t);
+}
+
+/// a mod q, canonical, for a <= 253
+static inline
+fq_vec_t fq_vec_red(const fq_vec_t a) {
+    /* W_RED127_: a + 1 carries into the 8th bit iff a >= q. No lane
+     * comparisons: compilers split them into scalar ones on vectors wider
+     * than the SIMD of the target */
+    return (a + ((a + 1) >> 7)) & Q;
+}
+
+/// a mod q, canonical, for any 16-bit lane
+static inline
+fq_vec_t fq_vec_red_wide(const fq_vec_wide_t a) {
+    return fq_vec_red(fq_vec_fold_narrow(fq_vec_fold(a)));
+}
+
+/// b in every lane, widened. Broadcasting b on the narrow vector lets the
+/// compiler use a native splat, instead of building the wide one in memory
+static inline
+fq_vec_wide_t fq_vec_splat(const FQ_ELEM b) {
+    const fq_vec_t t = (fq_vec_t){0} + b;
+    return fq_vec_widen(t);
+}
+
+/// a*b mod q, not canonical: at most 2q-3, as a*b is at most (q-1)^2
+static inline
+fq_vec_wide_t fq_vec_mul_lazy(const fq_vec_t a, const fq_vec_wide_t b) {
+    return fq_vec_fold(fq_vec_widen(a) * b);
+}
+
+/// a*b mod q, canonical
+static inline
+fq_vec_t fq_vec_mul(const fq_vec_t a, const fq_vec_wide_t b) {
+    return fq_vec_red(fq_vec_fold_narrow(fq_vec_widen(a) * b));
+}
+
+#endif
@@ -34,6 +34,67 @@ void swap_rows(FQ_ELEM r[N],
     memcpy(s, tmp, sizeof(FQ_ELEM) * N);
 } /* end swap_rows */
 
+/// rescales a row from column start on
+/// \param row[in/out]: N elements, row[i] *= s for i in range(start, N)
+/// \param s: scaling factor
+static inline
+void row_rescale(FQ_ELEM row[N],
+                 const uint32_t start,
+                 const FQ_ELEM s) {
+   uint32_t i = start;
+#ifdef USE_VECTOR_EXT
+   /* scalar head up to a lane boundary, then whole lanes */
+   for(; (i % FQ_VEC_LANES) && (i < N); i++) {
+      row[i] = fq_mul(s, row[i]);
+   }
+   const fq_vec_wide_t sv = fq_vec_splat(s);
+   for(; i + FQ_VEC_LANES <= N; i += FQ_VEC_LANES) {
+      fq_vec_store(row + i, fq_vec_mul(fq_vec_load(row + i), sv));
+   }
+   if (i < N) {
+      const fq_vec_t t = fq_vec_load_partial(row + i, N - i);
+      fq_vec_store_partial(row + i, fq_vec_mul(t, sv), N - i);
+   }
+#else
+   for(; i < N; i++) {
+      row[i] = fq_mul(s, row[i]);
+   }
+#endif
+} /* end row_rescale */
+
+/// subtracts a multiple of the pivot row from a row
+/// \param row[in/out]: N elements, row[i] -= m*pivot_row[i] for i in range(N)
+/// \param pivot_row[in]: N elements
+/// \param m: multiplier
+static inline
+void row_reduce(FQ_ELEM row[N],
+                const FQ_ELEM pivot_row[N],
+                const FQ_ELEM m) {
+#ifdef USE_VECTOR_EXT
+   /* the row is canonical, subtracting 0 leaves it untouched */
+   if (m == 0) {
+      return;
+   }
+
+   const fq_vec_wide_t mv = fq_vec_splat(m);
+   uint32_t i = 0;
+   for(; i + FQ_VEC_LANES <= N; i += FQ_VEC_LANES) {
+      const fq_vec_t t = fq_vec_load(row + i) + (Q - fq_vec_mul(fq_vec_load(pivot_row + i), mv));
+      fq_vec_store(row + i, fq_vec_red(t));
+   }
+   if (i < N) {
+      const fq_vec_t t = fq_vec_load_partial(row + i, N - i) +
+                         (Q - fq_vec_mul(fq_vec_load_partial(pivot_row + i, N - i), mv));
+      fq_vec_store_partial(row + i, fq_vec_red(t), N - i);
+   }
+#else
+   for(uint32_t i = 0; i < N; i++) {
+      FQ_ELEM tmp = fq_mul(m, pivot_row[i]);
+      row[i] = fq_sub(row[i], tmp);
+   }
+#endif
+} /* end row_reduce */
+
 /* Calculate pivot flag array */
 void generator_get_pivot_flags(const rref_generator_mat_t *const G,
                                uint8_t pivot_flag [N]) {
@@ -91,21 +152,14 @@ int generator_RREF(generator_mat_t *G,
 
       /* rescale pivot row to have pivot = 1. Values at the left of the pivot
        * are already set to zero by previous iterations */
-      for(unsigned i = pivot_column; i < N; i++) {
-         G->values[pivot_row][i] = fq_mul(scaling_factor, G->values[pivot_row][i]);
-      }
+      row_rescale(G->values[pivot_row], pivot_column, scaling_factor);
 
       /* Subtract the now placed and reduced pivot rows, from the others,
        * after rescaling it */
       for(unsigned row_idx = 0; row_idx < K; row_idx++) {
          if (row_idx != pivot_row) {
             FQ_ELEM multiplier = G->values[row_idx][pivot_column];
-            /* all elements before the pivot in the pivot row are null, no need to
-             * subtract them from other rows. */
-            for(unsigned col_idx = 0; col_idx < N; col_idx++) {
-               FQ_ELEM tmp = fq_mul(multiplier, G->values[pivot_row][col_idx]);
-               G->values[row_idx][col_idx] = fq_sub(G->values[row_idx][col_idx], tmp);
-            }
+            row_reduce(G->values[row_idx], G->values[pivot_row], multiplier);
          }
       }
    }
@@ -182,21 +236,14 @@ int generator_RREF_pivot_reuse(generator_mat_t *G,
 
         /* rescale pivot row to have pivot = 1. Values at the left of the pivot
          * are already set to zero by previous iterations */
-        for (uint32_t i = pivot_column; i < N; i++) {
-            G->values[pivot_row][i] = fq_mul(scaling_factor, G->values[pivot_row][i]);
-        }
+        row_rescale(G->values[pivot_row], pivot_column, scaling_factor);
 
         /* Subtract the now placed and reduced pivot rows, from the others,
          * after rescaling it */
         for (uint32_t row_idx = 0; row_idx < K; row_idx++) {
             if (row_idx != pivot_row) {
                 FQ_ELEM multiplier = G->values[row_idx][pivot_column];
-                /* all elements before the pivot in the pivot row are null, no need to
-                 * subtract them from other rows. */
-                for (int col_idx = 0; col_idx < N; col_idx++) {
-                    FQ_ELEM tmp = fq_mul(multiplier, G->values[pivot_row][col_idx]);
-                    G->values[row_idx][col_idx] = fq_sub(G->values[row_idx][col_idx], tmp);
-                }
+                row_reduce(G->values[row_idx], G->values[pivot_row], multiplier);
             }
         }
     }
@@ -488,6 +535,24 @@ void row_mat_mult(FQ_ELEM *out,
                     FQ_ELEM M[K][K],
                     uint8_t r,
                     uint8_t c){
+#ifdef USE_VECTOR_EXT
+    /* up to K lazy products of at most 2q-3 per lane fit in 16 bits. The
+     * last strip overlaps the previous one instead of running past c: out is
+     * only written, so recomputing the overlapping columns is harmless */
+    if (c >= FQ_VEC_LANES) {
+        for(uint32_t start = 0; start < c; start += FQ_VEC_LANES){
+            if (start + FQ_VEC_LANES > c) {
+                start = c - FQ_VEC_LANES;
+            }
+            fq_vec_wide_t acc = {0};
+            for(uint8_t j=0; j<r; j++){
+                acc += fq_vec_mul_lazy(fq_vec_load(M[j] + start), fq_vec_splat(row[j]));
+            }
+            fq_vec_store(out + start, fq_vec_red_wide(acc));
+        }
+        return;
+    }
+#endif
     for(uint8_t i=0; i<c; i++){
         out[i] = 0;
         for(uint8_t j=0; j<r; j++){